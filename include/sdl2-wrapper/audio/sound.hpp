@@ -46,10 +46,35 @@ public:
 
 	sound(const sound &) = delete;
 
-	sound(sound &&rhs) : _spec(rhs._spec), _buffer(rhs._buffer), _length(rhs._length) {}
+	sound(sound &&rhs) noexcept
+		: _spec(rhs._spec), _convert(rhs._convert), _buffer(rhs._buffer), _length(rhs._length), _position(rhs._position), _converted(rhs._converted) {
+		rhs._buffer = nullptr;
+		rhs._length = 0;
+		rhs._position = 0;
+	}
+
+	sound &operator =(const sound &) = delete;
+
+	sound &operator =(sound &&rhs) noexcept {
+		if (this != &rhs) {
+			free();
+			_spec = rhs._spec;
+			_convert = rhs._convert;
+			_buffer = rhs._buffer;
+			_length = rhs._length;
+			_position = rhs._position;
+			_converted = rhs._converted;
+			rhs._buffer = nullptr;
+			rhs._length = 0;
+			rhs._position = 0;
+		}
+		return *this;
+	}
 
 	~sound() { free(); }
 
+	bool valid() const noexcept { return (_buffer != nullptr); }
+
 	const audio_spec &spec() const noexcept { return _spec; }
 
 	auto frequency() const noexcept { return spec().freq; }
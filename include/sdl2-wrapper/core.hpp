@@ -34,6 +34,8 @@
 
 // SDL_log.h
 #include "core/log.hpp"
+#include "core/binary_log.hpp"
+#include "core/async_log.hpp"
 
 // SDL_assert.h
 #include "core/assert.hpp"
@@ -0,0 +1,358 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_CORE_ASYNC_LOG_HPP_
+#define SDL2_WRAPPER_CORE_ASYNC_LOG_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sdl { inline namespace core {
+
+class async_log final {
+public:
+	using sink = std::function<void (const char *data, std::size_t size)>;
+
+	enum class encoding {
+		text,
+		binary,
+	};
+
+	struct statistics {
+		Uint64 records = 0;
+		Uint64 dropped = 0;
+		Uint64 bytes = 0;
+	};
+
+	explicit async_log(const char *path, encoding mode = encoding::text, std::size_t ring_size = 1 << 16, Uint32 interval = 5)
+		: async_log(sink(), mode, ring_size, interval) {
+		_file = SDL_RWFromFile(path, (mode == encoding::binary) ? "wb" : "ab");
+		if (_file == nullptr) return;
+
+		_sink = [this](const char *data, std::size_t size) { SDL_RWwrite(_file, data, 1, size); };
+		start();
+	}
+
+	explicit async_log(sink sink, encoding mode = encoding::text, std::size_t ring_size = 1 << 16, Uint32 interval = 5)
+		: _sink(std::move(sink)), _encoding(mode), _ring_size(ring_size), _interval(interval), _id(next_id()) {
+		_origin = SDL_GetPerformanceCounter();
+		_frequency = SDL_GetPerformanceFrequency();
+		if (_sink) start();
+	}
+
+	async_log(const async_log &) = delete;
+
+	async_log &operator =(const async_log &) = delete;
+
+	// SDL does not synchronize its log output function with SDL_LogSetOutputFunction,
+	// so a thread still inside SDL_Log (or push/write) during destruction may
+	// touch a dead object. Stop logging from other threads before destroying
+	// an installed async_log.
+	~async_log() {
+		uninstall();
+		{
+			std::lock_guard<std::mutex> lock(_wake_mutex);
+			_stop = true;
+		}
+		_wake.notify_all();
+		if (_thread.joinable()) _thread.join();
+
+		flush();
+		if (_file != nullptr) SDL_RWclose(_file);
+
+		std::lock_guard<std::mutex> lock(_rings_mutex);
+		for (auto &r : _rings) r->closed.store(true, std::memory_order_release);
+	}
+
+	bool valid() const noexcept { return _thread.joinable(); }
+
+	void install() noexcept {
+		if (!valid() || _installed) return;
+
+		log::output(&_previous_callback, &_previous_userdata);
+		log::output(&async_log::output, this);
+		_installed = true;
+	}
+
+	void uninstall() noexcept {
+		if (!_installed) return;
+
+		log::output(_previous_callback, _previous_userdata);
+		_installed = false;
+	}
+
+	bool push(log::category category, log::priority priority, const char *message) noexcept {
+		return push(static_cast<int>(category), static_cast<SDL_LogPriority>(priority), message);
+	}
+
+	bool push(int category, SDL_LogPriority priority, const char *message) noexcept {
+		return push(category, priority, 0, message, std::strlen(message));
+	}
+
+	template <log::category Category, log::priority Priority, typename Format, typename ...Args>
+	bool write(Format, const Args &...args) noexcept {
+		static_assert(detail::count_placeholders(Format::value()) >= 0, "malformed log format string");
+		static_assert(detail::count_placeholders(Format::value()) == sizeof...(Args), "log format placeholder count does not match argument count");
+		return write<Format>(std::integral_constant<bool, log::built<Category, Priority>()>(), Category, Priority, args...);
+	}
+
+	void flush() {
+		std::lock_guard<std::mutex> lock(_drain_mutex);
+		drain();
+	}
+
+	statistics stats() const noexcept {
+		statistics result;
+		result.records = _records.load(std::memory_order_relaxed);
+		result.dropped = _dropped.load(std::memory_order_relaxed);
+		result.bytes = _bytes.load(std::memory_order_relaxed);
+		return result;
+	}
+
+private:
+	using record = binary_log::record;
+
+	// Shared by the log and the producing thread, so whichever goes away
+	// last frees it.
+	struct ring_slot {
+		explicit ring_slot(std::size_t size) : ring(size) {}
+
+		detail::spsc_ring ring;
+		std::atomic<bool> retired { false };
+		std::atomic<bool> closed { false };
+	};
+
+	// Retires the thread's rings when it exits; drain() frees them once
+	// their last records are written.
+	struct local_rings {
+		std::vector<std::pair<Uint64, std::shared_ptr<ring_slot>>> entries;
+
+		~local_rings() {
+			for (auto &entry : entries) entry.second->retired.store(true, std::memory_order_release);
+		}
+	};
+
+	static Uint64 next_id() noexcept {
+		static std::atomic<Uint64> id { 1 };
+		return id.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static void SDLCALL output(void *userdata, int category, SDL_LogPriority priority, const char *message) {
+		static_cast<async_log *>(userdata)->push(category, priority, message);
+	}
+
+	template <typename Format, typename ...Args>
+	bool write(std::false_type, log::category, log::priority, const Args &...) noexcept { return false; }
+
+	template <typename Format, typename ...Args>
+	bool write(std::true_type, log::category category, log::priority priority, const Args &...args) noexcept {
+		if (priority < log::category_priority(category)) return false;
+
+		Uint32 id;
+		try {
+			id = binary_log::format_id<Format, Args...>();
+		} catch (...) {
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		unsigned char payload[SDL_MAX_LOG_MESSAGE];
+		auto size = binary_log::encode(payload, sizeof(payload), args...);
+		return push(static_cast<int>(category), static_cast<SDL_LogPriority>(priority), id, payload, size);
+	}
+
+	bool push(int category, SDL_LogPriority priority, Uint32 format, const void *payload, std::size_t size) noexcept {
+		auto ring = local_ring();
+		if ((ring != nullptr) && (format == 0)) size = std::min(size, ring->capacity() / 4 - sizeof(record));
+		if ((ring == nullptr) || (size + sizeof(record) > ring->capacity() / 4)) {
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		record header;
+		header.timestamp = SDL_GetPerformanceCounter();
+		header.category = category;
+		header.priority = static_cast<Uint32>(priority);
+		header.length = static_cast<Uint32>(size);
+		header.format = format;
+
+		auto pushed = ring->push(&header, sizeof(header), payload, header.length);
+		if (!pushed) _dropped.fetch_add(1, std::memory_order_relaxed);
+		if (ring->size() > ring->capacity() / 2) _wake.notify_one();
+		return pushed;
+	}
+
+	detail::spsc_ring *local_ring() noexcept {
+		thread_local local_rings rings;
+		auto &entries = rings.entries;
+
+		for (auto &entry : entries) {
+			if (entry.first == _id) return &entry.second->ring;
+		}
+
+		// Drop rings of logs that no longer exist before adding a new one.
+		entries.erase(std::remove_if(entries.begin(), entries.end(), [](const std::pair<Uint64, std::shared_ptr<ring_slot>> &entry) {
+			return entry.second->closed.load(std::memory_order_acquire);
+		}), entries.end());
+
+		try {
+			auto slot = std::make_shared<ring_slot>(_ring_size);
+			std::lock_guard<std::mutex> lock(_rings_mutex);
+			_rings.push_back(slot);
+			entries.emplace_back(_id, std::move(slot));
+			return &entries.back().second->ring;
+		} catch (...) {
+			return nullptr;
+		}
+	}
+
+	void start() {
+		if (_encoding == encoding::binary) binary_log::write_header(_sink, _origin, _frequency);
+		_thread = std::thread([this] { work(); });
+	}
+
+	void work() {
+		std::unique_lock<std::mutex> lock(_wake_mutex);
+		while (!_stop) {
+			_wake.wait_for(lock, std::chrono::milliseconds(_interval));
+			lock.unlock();
+			flush();
+			lock.lock();
+		}
+	}
+
+	void drain() {
+		std::lock_guard<std::mutex> lock(_rings_mutex);
+
+		_buffer.clear();
+		for (auto it = _rings.begin(); it != _rings.end();) {
+			// Read before draining so the exited thread's last records are seen.
+			auto retired = (*it)->retired.load(std::memory_order_acquire);
+			auto ring = &(*it)->ring;
+
+			record header;
+			while (ring->readable() >= sizeof(header)) {
+				ring->peek(&header, sizeof(header));
+				_payload.resize(header.length);
+				ring->peek(_payload.data(), header.length, sizeof(header));
+				if (_encoding == encoding::binary) {
+					serialize(header);
+				} else {
+					format(header);
+				}
+				ring->consume(sizeof(header) + header.length);
+				_records.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			it = retired ? _rings.erase(it) : (it + 1);
+		}
+
+		if (!_buffer.empty() && _sink) {
+			_sink(_buffer.data(), _buffer.size());
+			_bytes.fetch_add(_buffer.size(), std::memory_order_relaxed);
+		}
+	}
+
+	bool definition(Uint32 id, binary_log::definition &result) {
+		if (id > _definitions.size()) {
+			binary_log::definition entry;
+			for (auto next = static_cast<Uint32>(_definitions.size()) + 1; binary_log::lookup(next, entry); ++next) {
+				_definitions.push_back(entry);
+			}
+			_written.resize(_definitions.size(), false);
+		}
+		if ((id == 0) || (id > _definitions.size())) return false;
+
+		result = _definitions[id - 1];
+		return true;
+	}
+
+	void format(const record &header) {
+		binary_log::render_prefix(_buffer, header, _origin, _frequency);
+
+		binary_log::definition entry;
+		if (header.format == 0) {
+			_buffer.append(reinterpret_cast<const char *>(_payload.data()), _payload.size());
+		} else if (definition(header.format, entry)) {
+			binary_log::render_payload(_buffer, entry.format, entry.signature, _payload.data(), _payload.size());
+		}
+		_buffer.push_back('\n');
+	}
+
+	void serialize(const record &header) {
+		binary_log::definition entry;
+		if ((header.format != 0) && definition(header.format, entry) && !_written[header.format - 1]) {
+			binary_log::write_definition(_buffer, header.format, entry);
+			_written[header.format - 1] = true;
+		}
+
+		_buffer.push_back(static_cast<char>(binary_log::kind::record));
+		_buffer.append(reinterpret_cast<const char *>(&header), sizeof(header));
+		_buffer.append(reinterpret_cast<const char *>(_payload.data()), _payload.size());
+	}
+
+private:
+	sink _sink;
+	const encoding _encoding;
+	SDL_RWops *_file = nullptr;
+	const std::size_t _ring_size;
+	const Uint32 _interval;
+	const Uint64 _id;
+	Uint64 _origin = 0;
+	Uint64 _frequency = 1;
+
+	std::mutex _rings_mutex;
+	std::vector<std::shared_ptr<ring_slot>> _rings;
+
+	std::mutex _drain_mutex;
+	std::string _buffer;
+	std::vector<unsigned char> _payload;
+	std::vector<binary_log::definition> _definitions;
+	std::vector<bool> _written;
+
+	std::mutex _wake_mutex;
+	std::condition_variable _wake;
+	bool _stop = false;
+	std::thread _thread;
+
+	bool _installed = false;
+	log::callback _previous_callback = nullptr;
+	void *_previous_userdata = nullptr;
+
+	std::atomic<Uint64> _records { 0 };
+	std::atomic<Uint64> _dropped { 0 };
+	std::atomic<Uint64> _bytes { 0 };
+};
+
+} } // namespace sdl::core
+
+#endif // SDL2_WRAPPER_CORE_ASYNC_LOG_HPP_
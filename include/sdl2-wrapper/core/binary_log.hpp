@@ -0,0 +1,426 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_CORE_BINARY_LOG_HPP_
+#define SDL2_WRAPPER_CORE_BINARY_LOG_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace sdl { inline namespace core {
+
+// Binary logs store headers, records and arguments in the writer's native
+// byte order and struct layout; they are meant to be decoded on the same
+// platform. decode() rejects logs whose magic shows the other byte order.
+struct binary_log final {
+	using sink = std::function<void (const char *data, std::size_t size)>;
+
+	static constexpr Uint32 magic = 0x4c4c4453; // "SDLL"
+	static constexpr Uint32 version = 1;
+
+	enum class kind : Uint8 {
+		definition = 0,
+		record = 1,
+	};
+
+	struct record {
+		Uint64 timestamp;
+		Sint32 category;
+		Uint32 priority;
+		Uint32 length;
+		Uint32 format;
+	};
+
+	struct definition {
+		const char *format;
+		std::string signature;
+	};
+
+	class writer final {
+	public:
+		writer(unsigned char *data, std::size_t capacity) noexcept : _data(data), _capacity(capacity) {}
+
+		void put(const void *data, std::size_t size) noexcept {
+			auto count = std::min(size, _capacity - _size);
+			std::memcpy(_data + _size, data, count);
+			_size += count;
+		}
+
+		void put_string(const char *str, std::size_t size) noexcept {
+			auto room = (_capacity > _size + sizeof(Uint32)) ? (_capacity - _size - sizeof(Uint32)) : 0;
+			auto length = static_cast<Uint32>(std::min(size, room));
+			put(&length, sizeof(length));
+			put(str, length);
+		}
+
+		std::size_t size() const noexcept { return _size; }
+
+	private:
+		unsigned char *_data;
+		std::size_t _capacity;
+		std::size_t _size = 0;
+	};
+
+	template <typename T, int Kind = detail::format_kind<T>::value>
+	struct argument;
+
+	template <typename Format, typename ...Args>
+	static Uint32 format_id() {
+		static const Uint32 id = register_format(Format::value(), signature<Args...>());
+		return id;
+	}
+
+	template <typename ...Args>
+	static std::size_t encode(unsigned char *data, std::size_t capacity, const Args &...args) noexcept {
+		writer out(data, capacity);
+		int expand[] = { 0, (argument<Args>::encode(out, args), 0)... };
+		(void)expand;
+		return out.size();
+	}
+
+	static Uint32 register_format(const char *format, std::string signature) {
+		std::lock_guard<std::mutex> lock(registry_mutex());
+		registry().push_back(definition { format, std::move(signature) });
+		return static_cast<Uint32>(registry().size());
+	}
+
+	static bool lookup(Uint32 id, definition &result) {
+		std::lock_guard<std::mutex> lock(registry_mutex());
+		if ((id == 0) || (id > registry().size())) return false;
+
+		result = registry()[id - 1];
+		return true;
+	}
+
+	static const char *priority_name(SDL_LogPriority priority) noexcept {
+		static const char *names[] = { "", "VERBOSE", "DEBUG", "INFO", "WARN", "ERROR", "CRITICAL" };
+		return ((priority > 0) && (priority < SDL_NUM_LOG_PRIORITIES)) ? names[priority] : "";
+	}
+
+	static void render_prefix(std::string &out, const record &header, Uint64 origin, Uint64 frequency) {
+		char prefix[64];
+		auto seconds = static_cast<double>(header.timestamp - origin) / static_cast<double>(frequency);
+		auto length = std::snprintf(prefix, sizeof(prefix), "%12.6f %-8s %2d: ", seconds, priority_name(static_cast<SDL_LogPriority>(header.priority)), header.category);
+		out.append(prefix, static_cast<std::size_t>(std::max(length, 0)));
+	}
+
+	// Returns false when the payload is too short for the signature.
+	static bool render_payload(std::string &out, const char *format, const std::string &signature, const unsigned char *payload, std::size_t size) {
+		char text[SDL_MAX_LOG_MESSAGE];
+		detail::format_buffer buffer(text, sizeof(text));
+
+		std::size_t position = 0;
+		auto read = [&](void *value, std::size_t count) {
+			if (position + count > size) return false;
+			std::memcpy(value, payload + position, count);
+			position += count;
+			return true;
+		};
+		auto left = [&] { return size - position; };
+
+		auto result = true;
+		auto fmt = format;
+		for (auto code : signature) {
+			bool placeholder;
+			fmt = detail::format_literal(buffer, fmt, placeholder);
+			if (!placeholder) break;
+
+			if (!render_argument(buffer, code, read, left)) {
+				result = false;
+				break;
+			}
+		}
+		detail::format_to(buffer, fmt);
+
+		out.append(buffer.c_str(), buffer.size());
+		return result;
+	}
+
+	static void write_header(const sink &out, Uint64 origin, Uint64 frequency) {
+		Uint32 tag[2] = { magic, version };
+		unsigned char header[24];
+		std::memcpy(header, tag, 8);
+		std::memcpy(header + 8, &origin, 8);
+		std::memcpy(header + 16, &frequency, 8);
+		out(reinterpret_cast<const char *>(header), sizeof(header));
+	}
+
+	static void write_definition(std::string &out, Uint32 id, const definition &entry) {
+		auto format_length = static_cast<Uint32>(std::strlen(entry.format));
+		auto signature_length = static_cast<Uint32>(entry.signature.size());
+
+		out.push_back(static_cast<char>(kind::definition));
+		out.append(reinterpret_cast<const char *>(&id), sizeof(id));
+		out.append(reinterpret_cast<const char *>(&format_length), sizeof(format_length));
+		out.append(reinterpret_cast<const char *>(&signature_length), sizeof(signature_length));
+		out.append(entry.format, format_length);
+		out.append(entry.signature);
+	}
+
+	static bool decode(SDL_RWops *in, const sink &out) {
+		auto read = [in](void *data, std::size_t size) { return (size == 0) || (SDL_RWread(in, data, size, 1) == 1); };
+
+		// Sizes come from the file, so never trust one beyond what is left.
+		auto total = SDL_RWsize(in);
+		auto remaining = [in, total]() -> Uint64 {
+			auto position = SDL_RWtell(in);
+			if ((total < 0) || (position < 0)) return Uint64(1) << 24;
+			return (total > position) ? static_cast<Uint64>(total - position) : 0;
+		};
+
+		Uint32 header_magic = 0;
+		Uint32 header_version = 0;
+		Uint64 origin = 0;
+		Uint64 frequency = 1;
+		if (!read(&header_magic, 4) || !read(&header_version, 4) || !read(&origin, 8) || !read(&frequency, 8)) {
+			SDL_SetError("binary log header is truncated");
+			return false;
+		}
+		if (header_magic == SDL_Swap32(magic)) {
+			SDL_SetError("binary log was written with the other byte order");
+			return false;
+		}
+		if ((header_magic != magic) || (header_version != version) || (frequency == 0)) {
+			SDL_SetError("not a binary log");
+			return false;
+		}
+
+		std::unordered_map<Uint32, std::pair<std::string, std::string>> definitions;
+		std::vector<unsigned char> payload;
+		std::string line;
+
+		Uint8 tag;
+		while (read(&tag, 1)) {
+			if (tag == static_cast<Uint8>(kind::definition)) {
+				Uint32 id, format_length, signature_length;
+				if (!read(&id, 4) || !read(&format_length, 4) || !read(&signature_length, 4) || (id == 0)) break;
+				if (static_cast<Uint64>(format_length) + signature_length > remaining()) break;
+
+				std::string format(format_length, '\0'), signature(signature_length, '\0');
+				if (!read(&format[0], format_length) || !read(&signature[0], signature_length)) break;
+
+				definitions[id] = std::make_pair(std::move(format), std::move(signature));
+			} else if (tag == static_cast<Uint8>(kind::record)) {
+				record header;
+				if (!read(&header, sizeof(header)) || (header.length > remaining())) break;
+
+				payload.resize(header.length);
+				if (!read(payload.data(), header.length)) break;
+
+				line.clear();
+				render_prefix(line, header, origin, frequency);
+				if (header.format == 0) {
+					line.append(reinterpret_cast<const char *>(payload.data()), payload.size());
+				} else {
+					auto it = definitions.find(header.format);
+					if ((it != definitions.end()) && !render_payload(line, it->second.first.c_str(), it->second.second, payload.data(), payload.size())) {
+						SDL_SetError("corrupt binary log record");
+						return false;
+					}
+				}
+				line.push_back('\n');
+				out(line.data(), line.size());
+			} else {
+				SDL_SetError("corrupt binary log record");
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static bool decode(const char *input, const char *output) {
+		auto in = SDL_RWFromFile(input, "rb");
+		if (in == nullptr) return false;
+
+		auto out = SDL_RWFromFile(output, "wb");
+		if (out == nullptr) {
+			SDL_RWclose(in);
+			return false;
+		}
+
+		auto result = decode(in, [out](const char *data, std::size_t size) { SDL_RWwrite(out, data, 1, size); });
+		SDL_RWclose(out);
+		SDL_RWclose(in);
+		return result;
+	}
+
+private:
+	static std::mutex &registry_mutex() {
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	static std::vector<definition> &registry() {
+		static std::vector<definition> entries;
+		return entries;
+	}
+
+	template <typename ...Args>
+	static std::string signature() {
+		const char codes[] = { argument<Args>::code..., '\0' };
+		return std::string(codes);
+	}
+
+	template <typename Read, typename Left>
+	static bool render_argument(detail::format_buffer &out, char code, Read &read, Left &left) {
+		switch (code) {
+		case 'i': {
+			Sint64 value;
+			if (!read(&value, sizeof(value))) return false;
+			detail::format_argument(out, value);
+			return true;
+		}
+		case 'u':
+		case 'p': {
+			Uint64 value;
+			if (!read(&value, sizeof(value))) return false;
+			if (code == 'p') {
+				char text[24];
+				auto length = std::snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(value));
+				out.append(text, static_cast<std::size_t>(std::max(length, 0)));
+			} else {
+				detail::format_argument(out, value);
+			}
+			return true;
+		}
+		case 'd': {
+			double value;
+			if (!read(&value, sizeof(value))) return false;
+			detail::format_argument(out, value);
+			return true;
+		}
+		case 'b':
+		case 'c': {
+			char value;
+			if (!read(&value, sizeof(value))) return false;
+			if (code == 'b') {
+				detail::format_argument(out, value != 0);
+			} else {
+				detail::format_argument(out, value);
+			}
+			return true;
+		}
+		case 's': {
+			Uint32 length;
+			if (!read(&length, sizeof(length)) || (length > left())) return false;
+			std::string value(length, '\0');
+			if (!read(&value[0], length)) return false;
+			detail::format_argument(out, value);
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+};
+
+template <typename T>
+struct binary_log::argument<T, 1> {
+	static constexpr char code = std::is_signed<T>::value ? 'i' : 'u';
+
+	static void encode(writer &out, const T &value) noexcept {
+		std::conditional_t<std::is_signed<T>::value, Sint64, Uint64> wide = value;
+		out.put(&wide, sizeof(wide));
+	}
+};
+
+template <typename T>
+struct binary_log::argument<T, 2> {
+	static constexpr char code = 'd';
+
+	static void encode(writer &out, const T &value) noexcept {
+		auto wide = static_cast<double>(value);
+		out.put(&wide, sizeof(wide));
+	}
+};
+
+template <typename T>
+struct binary_log::argument<T, 3> {
+	using underlying_type = std::underlying_type_t<T>;
+
+	static constexpr char code = argument<underlying_type>::code;
+
+	static void encode(writer &out, const T &value) noexcept {
+		argument<underlying_type>::encode(out, static_cast<underlying_type>(value));
+	}
+};
+
+template <>
+struct binary_log::argument<bool, 0> {
+	static constexpr char code = 'b';
+
+	static void encode(writer &out, bool value) noexcept {
+		char byte = value ? 1 : 0;
+		out.put(&byte, 1);
+	}
+};
+
+template <>
+struct binary_log::argument<char, 0> {
+	static constexpr char code = 'c';
+
+	static void encode(writer &out, char value) noexcept { out.put(&value, 1); }
+};
+
+template <typename T>
+struct binary_log::argument<T *, 0> {
+	static constexpr char code = 'p';
+
+	static void encode(writer &out, const T *value) noexcept {
+		auto address = static_cast<Uint64>(reinterpret_cast<std::uintptr_t>(value));
+		out.put(&address, sizeof(address));
+	}
+};
+
+template <>
+struct binary_log::argument<const char *, 0> {
+	static constexpr char code = 's';
+
+	static void encode(writer &out, const char *value) noexcept {
+		if (value == nullptr) value = "(null)";
+		out.put_string(value, std::strlen(value));
+	}
+};
+
+template <>
+struct binary_log::argument<char *, 0> : binary_log::argument<const char *, 0> {};
+
+template <std::size_t N>
+struct binary_log::argument<char[N], 0> : binary_log::argument<const char *, 0> {};
+
+template <>
+struct binary_log::argument<std::string, 0> {
+	static constexpr char code = 's';
+
+	static void encode(writer &out, const std::string &value) noexcept { out.put_string(value.data(), value.size()); }
+};
+
+} } // namespace sdl::core
+
+#endif // SDL2_WRAPPER_CORE_BINARY_LOG_HPP_
@@ -22,6 +22,17 @@
 #ifndef SDL2_WRAPPER_CORE_LOG_HPP_
 #define SDL2_WRAPPER_CORE_LOG_HPP_
 
+#ifndef SDL2_WRAPPER_LOG_DISABLED_CATEGORIES
+#define SDL2_WRAPPER_LOG_DISABLED_CATEGORIES 0
+#endif
+
+#ifndef SDL2_WRAPPER_LOG_MIN_PRIORITY
+#define SDL2_WRAPPER_LOG_MIN_PRIORITY SDL_LOG_PRIORITY_VERBOSE
+#endif
+
+#define SDL2_WRAPPER_LOG_FORMAT(str) \
+	([] { struct format_string { static constexpr const char *value() noexcept { return str; } }; return format_string(); }())
+
 namespace sdl { inline namespace core {
 
 struct log final {
@@ -72,6 +83,20 @@ struct log final {
 
 	static void reset_priorities() noexcept { SDL_LogResetPriorities(); }
 
+	template <category Category>
+	static constexpr bool compiled() noexcept {
+		return (static_cast<int>(Category) >= 64) ||
+			(((static_cast<Uint64>(SDL2_WRAPPER_LOG_DISABLED_CATEGORIES) >> static_cast<int>(Category)) & 1) == 0);
+	}
+
+	template <category Category, priority Priority>
+	static constexpr bool built() noexcept {
+		return compiled<Category>() && (static_cast<int>(Priority) >= static_cast<int>(SDL2_WRAPPER_LOG_MIN_PRIORITY));
+	}
+
+	template <category Category, priority Priority>
+	static bool enabled() noexcept { return built<Category, Priority>() && (Priority >= category_priority(Category)); }
+
 	template <typename ...Args>
 	static void printf(const char *fmt, Args &&...args) noexcept { SDL_Log(fmt, std::forward<Args>(args)...); }
 
@@ -110,14 +135,58 @@ struct log final {
 		SDL_LogMessage(static_cast<int>(category), static_cast<SDL_LogPriority>(priority), fmt, std::forward<Args>(args)...);
 	}
 
+	template <category Category, priority Priority, typename ...Args>
+	static void message(const char *fmt, Args &&...args) noexcept {
+		if (enabled<Category, Priority>()) message(Category, Priority, fmt, std::forward<Args>(args)...);
+	}
+
 	template <typename ...Args>
 	static void message(category category, priority priority, const char *fmt, va_list ap) noexcept {
 		SDL_LogMessageV(static_cast<int>(category), static_cast<SDL_LogPriority>(priority), fmt, ap);
 	}
 
+	template <category Category, priority Priority, typename Format, typename ...Args>
+	static void write(Format, const Args &...args) noexcept {
+		static_assert(detail::count_placeholders(Format::value()) >= 0, "malformed log format string");
+		static_assert(detail::count_placeholders(Format::value()) == sizeof...(Args), "log format placeholder count does not match argument count");
+		write(std::integral_constant<bool, built<Category, Priority>()>(), Category, Priority, Format::value(), args...);
+	}
+
+	template <category Category, typename Format, typename ...Args>
+	static void verbose(Format format, const Args &...args) noexcept { write<Category, priority::verbose>(format, args...); }
+
+	template <category Category, typename Format, typename ...Args>
+	static void debug(Format format, const Args &...args) noexcept { write<Category, priority::debug>(format, args...); }
+
+	template <category Category, typename Format, typename ...Args>
+	static void info(Format format, const Args &...args) noexcept { write<Category, priority::information>(format, args...); }
+
+	template <category Category, typename Format, typename ...Args>
+	static void warn(Format format, const Args &...args) noexcept { write<Category, priority::warning>(format, args...); }
+
+	template <category Category, typename Format, typename ...Args>
+	static void error(Format format, const Args &...args) noexcept { write<Category, priority::error>(format, args...); }
+
+	template <category Category, typename Format, typename ...Args>
+	static void critical(Format format, const Args &...args) noexcept { write<Category, priority::critical>(format, args...); }
+
 	static void output(callback *pcallback, void **puserdata) noexcept { SDL_LogGetOutputFunction(pcallback, puserdata); }
 
 	static void output(callback callback, void *userdata) noexcept { SDL_LogSetOutputFunction(callback, userdata); }
+
+private:
+	template <typename ...Args>
+	static void write(std::false_type, category, priority, const char *, const Args &...) noexcept {}
+
+	template <typename ...Args>
+	static void write(std::true_type, category category, priority priority, const char *fmt, const Args &...args) noexcept {
+		if (priority < category_priority(category)) return;
+
+		char buffer[SDL_MAX_LOG_MESSAGE];
+		detail::format_buffer out(buffer, sizeof(buffer));
+		detail::format_to(out, fmt, args...);
+		SDL_LogMessage(static_cast<int>(category), static_cast<SDL_LogPriority>(priority), "%s", out.c_str());
+	}
 };
 
 } } // namespace sdl::core
@@ -25,6 +25,10 @@
 #include "detail/type_traits.hpp"
 #include "detail/resource.hpp"
 #include "detail/calculate.hpp"
+#include "detail/hash.hpp"
+#include "detail/spsc_ring.hpp"
+#include "detail/format.hpp"
+#include "detail/zlib.hpp"
 
 #endif // SDL2_WRAPPER_DETAIL_HPP_
 
@@ -0,0 +1,176 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_DETAIL_FORMAT_HPP_
+#define SDL2_WRAPPER_DETAIL_FORMAT_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace sdl { namespace detail {
+
+constexpr int count_placeholders(const char *fmt) noexcept {
+	int count = 0;
+	for (; *fmt != '\0'; ++fmt) {
+		if ((fmt[0] == '{') && (fmt[1] == '}')) {
+			++count;
+			++fmt;
+		} else if (((fmt[0] == '{') && (fmt[1] == '{')) || ((fmt[0] == '}') && (fmt[1] == '}'))) {
+			++fmt;
+		} else if ((fmt[0] == '{') || (fmt[0] == '}')) {
+			return -1;
+		}
+	}
+	return count;
+}
+
+class format_buffer final {
+public:
+	format_buffer(char *data, std::size_t capacity) noexcept : _data(data), _capacity(capacity) { _data[0] = '\0'; }
+
+	void append(const char *str, std::size_t size) noexcept {
+		auto count = std::min(size, _capacity - 1 - _size);
+		std::memcpy(_data + _size, str, count);
+		_size += count;
+		_data[_size] = '\0';
+	}
+
+	void append(const char *str) noexcept { append(str, std::strlen(str)); }
+
+	void append(char c) noexcept { append(&c, 1); }
+
+	const char *c_str() const noexcept { return _data; }
+
+	std::size_t size() const noexcept { return _size; }
+
+private:
+	char *_data;
+	std::size_t _capacity;
+	std::size_t _size = 0;
+};
+
+template <typename T>
+inline void format_integer(format_buffer &out, T value) noexcept {
+	char digits[24];
+	auto end = digits + sizeof(digits);
+	auto p = end;
+
+	using unsigned_type = std::make_unsigned_t<T>;
+	auto magnitude = static_cast<unsigned_type>(value);
+	if (value < 0) magnitude = static_cast<unsigned_type>(0 - magnitude);
+
+	do {
+		*--p = static_cast<char>('0' + (magnitude % 10));
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (value < 0) *--p = '-';
+
+	out.append(p, static_cast<std::size_t>(end - p));
+}
+
+inline void format_value(format_buffer &out, bool value) noexcept { out.append(value ? "true" : "false"); }
+
+inline void format_value(format_buffer &out, char value) noexcept { out.append(value); }
+
+inline void format_value(format_buffer &out, const char *value) noexcept { out.append((value != nullptr) ? value : "(null)"); }
+
+inline void format_value(format_buffer &out, const std::string &value) noexcept { out.append(value.data(), value.size()); }
+
+inline void format_value(format_buffer &out, double value) noexcept {
+	char text[32];
+	auto length = std::snprintf(text, sizeof(text), "%g", value);
+	out.append(text, static_cast<std::size_t>(std::max(length, 0)));
+}
+
+inline void format_value(format_buffer &out, const void *value) noexcept {
+	char text[32];
+	auto length = std::snprintf(text, sizeof(text), "%p", value);
+	out.append(text, static_cast<std::size_t>(std::max(length, 0)));
+}
+
+template <typename T>
+using format_kind = std::integral_constant<int,
+	std::is_enum<T>::value ? 3 :
+	std::is_floating_point<T>::value ? 2 :
+	(std::is_integral<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value) ? 1 : 0>;
+
+template <typename T>
+inline void format_dispatch(format_buffer &out, const T &value, std::integral_constant<int, 0>) noexcept { format_value(out, value); }
+
+template <typename T>
+inline void format_dispatch(format_buffer &out, const T &value, std::integral_constant<int, 1>) noexcept {
+	format_integer(out, static_cast<std::conditional_t<std::is_signed<T>::value, long long, unsigned long long>>(value));
+}
+
+template <typename T>
+inline void format_dispatch(format_buffer &out, const T &value, std::integral_constant<int, 2>) noexcept { format_value(out, static_cast<double>(value)); }
+
+template <typename T>
+inline void format_dispatch(format_buffer &out, const T &value, std::integral_constant<int, 3>) noexcept {
+	using underlying_type = std::underlying_type_t<T>;
+	format_dispatch(out, static_cast<underlying_type>(value), format_kind<underlying_type>());
+}
+
+template <typename T>
+inline void format_argument(format_buffer &out, const T &value) noexcept { format_dispatch(out, value, format_kind<T>()); }
+
+template <typename T>
+inline void format_argument(format_buffer &out, T *value) noexcept { format_value(out, static_cast<const void *>(value)); }
+
+inline void format_argument(format_buffer &out, char *value) noexcept { format_value(out, static_cast<const char *>(value)); }
+
+inline void format_argument(format_buffer &out, const char *value) noexcept { format_value(out, value); }
+
+inline const char *format_literal(format_buffer &out, const char *fmt, bool &placeholder) noexcept {
+	placeholder = false;
+	while (*fmt != '\0') {
+		if ((fmt[0] == '{') && (fmt[1] == '}')) {
+			placeholder = true;
+			return fmt + 2;
+		}
+		if (((fmt[0] == '{') && (fmt[1] == '{')) || ((fmt[0] == '}') && (fmt[1] == '}'))) ++fmt;
+		out.append(*fmt++);
+	}
+	return fmt;
+}
+
+inline void format_to(format_buffer &out, const char *fmt) noexcept {
+	bool placeholder;
+	while (*fmt != '\0') fmt = format_literal(out, fmt, placeholder);
+}
+
+template <typename T, typename ...Args>
+inline void format_to(format_buffer &out, const char *fmt, const T &value, const Args &...args) noexcept {
+	bool placeholder;
+	auto next = format_literal(out, fmt, placeholder);
+	if (!placeholder) return;
+
+	format_argument(out, value);
+	format_to(out, next, args...);
+}
+
+} } // namespace sdl::detail
+
+#endif // SDL2_WRAPPER_DETAIL_FORMAT_HPP_
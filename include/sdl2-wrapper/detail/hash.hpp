@@ -0,0 +1,103 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_DETAIL_HASH_HPP_
+#define SDL2_WRAPPER_DETAIL_HASH_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+namespace sdl { namespace detail {
+
+struct fnv1a final {
+	using value_type = std::uint64_t;
+
+	static constexpr value_type offset_basis = 0xcbf29ce484222325ULL;
+	static constexpr value_type prime = 0x00000100000001b3ULL;
+
+	static constexpr value_type hash(const char *str, value_type value = offset_basis) noexcept {
+		while (*str != '\0') {
+			value = (value ^ static_cast<unsigned char>(*str++)) * prime;
+		}
+		return value;
+	}
+
+	static value_type hash(const void *data, std::size_t size, value_type value = offset_basis) noexcept {
+		for (std::size_t i = 0; i < size; ++i) {
+			value = (value ^ static_cast<const unsigned char *>(data)[i]) * prime;
+		}
+		return value;
+	}
+};
+
+struct crc32 final {
+	using value_type = std::uint32_t;
+
+	static value_type hash(const void *data, std::size_t size, value_type value = 0) noexcept {
+		static const auto table = make_table();
+
+		value = ~value;
+		for (std::size_t i = 0; i < size; ++i) {
+			value = table.values[(value ^ static_cast<const unsigned char *>(data)[i]) & 0xFF] ^ (value >> 8);
+		}
+		return ~value;
+	}
+
+private:
+	struct lookup_table {
+		value_type values[256];
+	};
+
+	static lookup_table make_table() noexcept {
+		lookup_table result;
+		for (value_type n = 0; n < 256; ++n) {
+			auto c = n;
+			for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
+			result.values[n] = c;
+		}
+		return result;
+	}
+};
+
+struct adler32 final {
+	using value_type = std::uint32_t;
+
+	static value_type hash(const void *data, std::size_t size, value_type value = 1) noexcept {
+		auto bytes = static_cast<const unsigned char *>(data);
+		value_type a = value & 0xFFFF;
+		value_type b = value >> 16;
+		while (size > 0) {
+			auto block = (size < 5552) ? size : 5552;
+			size -= block;
+			while (block-- > 0) {
+				a += *bytes++;
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+		return (b << 16) | a;
+	}
+};
+
+} } // namespace sdl::detail
+
+#endif // SDL2_WRAPPER_DETAIL_HASH_HPP_
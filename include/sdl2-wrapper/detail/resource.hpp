@@ -78,6 +78,61 @@ protected:
 	handle_holder _handle_holder;
 };
 
+template <typename Handle, void (*Release)(Handle *)>
+struct static_releaser {
+	void operator ()(Handle *p) const noexcept { Release(p); }
+};
+
+template <typename Handle, void (*Release)(Handle *)>
+class static_resource {
+public:
+	using type = Handle;
+	using handle = type *;
+	using releaser = static_releaser<Handle, Release>;
+	using handle_holder = std::unique_ptr<type, releaser>;
+
+	static_resource() noexcept = default;
+
+	explicit static_resource(handle p) noexcept
+		: _handle_holder(p) {}
+
+	static_resource(const static_resource &rhs) = delete;
+
+	static_resource(static_resource &&rhs) noexcept = default;
+
+	explicit static_resource(handle_holder &&rhs) noexcept
+		: _handle_holder(std::move(rhs)) {}
+
+	~static_resource() = default;
+
+	explicit operator bool() const { return valid(); }
+
+	static_resource &operator =(const static_resource &rhs) = delete;
+
+	static_resource &operator =(static_resource &&rhs) noexcept = default;
+
+	operator handle() const { return get(); }
+
+	handle get() const noexcept { return _handle_holder.get(); }
+
+	bool valid() const noexcept { return (get() != nullptr); }
+
+	void reset(handle_holder &&hh) noexcept { _handle_holder = std::move(hh); }
+
+	void destroy() noexcept { _handle_holder.reset(); }
+
+	handle release() noexcept { return _handle_holder.release(); }
+
+protected:
+	template <typename creator, typename... arguments>
+	static handle_holder make_resource(creator cfn, arguments&&... args) {
+		return handle_holder(cfn(std::forward<arguments>(args)...));
+	}
+
+protected:
+	handle_holder _handle_holder;
+};
+
 } } // namespace sdl::detail
 
 #endif // SDL2_WRAPPER_DETAIL_RESOURCE_HPP_
@@ -0,0 +1,109 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_DETAIL_SPSC_RING_HPP_
+#define SDL2_WRAPPER_DETAIL_SPSC_RING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+namespace sdl { namespace detail {
+
+class spsc_ring final {
+public:
+	explicit spsc_ring(std::size_t capacity) : _capacity(round_up(capacity)), _data(std::make_unique<unsigned char[]>(_capacity)) {}
+
+	spsc_ring(const spsc_ring &) = delete;
+
+	spsc_ring &operator =(const spsc_ring &) = delete;
+
+	std::size_t capacity() const noexcept { return _capacity; }
+
+	std::size_t size() const noexcept {
+		return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+	}
+
+	bool empty() const noexcept { return (size() == 0); }
+
+	bool push(const void *header, std::size_t header_size, const void *body = nullptr, std::size_t body_size = 0) noexcept {
+		auto head = _head.load(std::memory_order_relaxed);
+		auto tail = _tail.load(std::memory_order_acquire);
+		if (_capacity - (head - tail) < header_size + body_size) return false;
+
+		copy_in(head, header, header_size);
+		copy_in(head + header_size, body, body_size);
+		_head.store(head + header_size + body_size, std::memory_order_release);
+		return true;
+	}
+
+	std::size_t readable() const noexcept {
+		return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+	}
+
+	void peek(void *out, std::size_t size, std::size_t offset = 0) const noexcept {
+		copy_out(_tail.load(std::memory_order_relaxed) + offset, out, size);
+	}
+
+	void consume(std::size_t size) noexcept {
+		_tail.store(_tail.load(std::memory_order_relaxed) + size, std::memory_order_release);
+	}
+
+private:
+	static std::size_t round_up(std::size_t capacity) noexcept {
+		std::size_t result = 64;
+		while (result < capacity) result <<= 1;
+		return result;
+	}
+
+	void copy_in(std::size_t position, const void *data, std::size_t size) noexcept {
+		if (size == 0) return;
+
+		auto offset = position & (_capacity - 1);
+		auto first = std::min(size, _capacity - offset);
+		std::memcpy(_data.get() + offset, data, first);
+		std::memcpy(_data.get(), static_cast<const unsigned char *>(data) + first, size - first);
+	}
+
+	void copy_out(std::size_t position, void *data, std::size_t size) const noexcept {
+		if (size == 0) return;
+
+		auto offset = position & (_capacity - 1);
+		auto first = std::min(size, _capacity - offset);
+		std::memcpy(data, _data.get() + offset, first);
+		std::memcpy(static_cast<unsigned char *>(data) + first, _data.get(), size - first);
+	}
+
+private:
+	const std::size_t _capacity;
+	std::unique_ptr<unsigned char[]> _data;
+	char _pad0[SDL_CACHELINE_SIZE];
+	std::atomic<std::size_t> _head { 0 };
+	char _pad1[SDL_CACHELINE_SIZE];
+	std::atomic<std::size_t> _tail { 0 };
+	char _pad2[SDL_CACHELINE_SIZE];
+};
+
+} } // namespace sdl::detail
+
+#endif // SDL2_WRAPPER_DETAIL_SPSC_RING_HPP_
@@ -0,0 +1,467 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_DETAIL_ZLIB_HPP_
+#define SDL2_WRAPPER_DETAIL_ZLIB_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace sdl { namespace detail {
+
+struct zlib final {
+	using byte = std::uint8_t;
+
+	static void compress(const void *data, std::size_t size, std::vector<byte> &out, int effort = 16) {
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		auto bytes = static_cast<const byte *>(data);
+		if (effort <= 0) {
+			store(bytes, size, out);
+		} else {
+			bit_writer writer { out };
+			writer.put(1, 1);
+			writer.put(1, 2);
+			encode(bytes, size, writer, effort);
+			literal(writer, 256);
+			writer.flush();
+		}
+
+		auto checksum = adler32::hash(bytes, size);
+		for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<byte>(checksum >> shift));
+	}
+
+	// Appends the inflated stream to out. Fails as soon as the output would
+	// grow past limit bytes, so a hostile stream cannot exhaust memory.
+	static bool decompress(const void *data, std::size_t size, std::vector<byte> &out, std::size_t limit = std::numeric_limits<std::size_t>::max()) {
+		auto bytes = static_cast<const byte *>(data);
+		if ((size < 2) || ((bytes[0] & 0x0F) != 8) || (((bytes[0] << 8) | bytes[1]) % 31 != 0) || ((bytes[1] & 0x20) != 0)) return false;
+
+		auto start = out.size();
+		auto end = (limit > std::numeric_limits<std::size_t>::max() - start) ? std::numeric_limits<std::size_t>::max() : start + limit;
+		bit_reader reader { bytes + 2, size - 2 };
+		huffman literals;
+		huffman distances;
+
+		bool last = false;
+		while (!last) {
+			last = (reader.bits(1) != 0);
+			switch (reader.bits(2)) {
+			case 0:
+				if (!stored(reader, out, end)) return false;
+				break;
+
+			case 1:
+				fixed(literals, distances);
+				if (!inflate(reader, literals, distances, out, start, end)) return false;
+				break;
+
+			case 2:
+				if (!dynamic(reader, literals, distances) || !inflate(reader, literals, distances, out, start, end)) return false;
+				break;
+
+			default:
+				return false;
+			}
+			if (reader.overrun()) return false;
+		}
+
+		reader.align();
+		std::uint32_t checksum = 0;
+		for (int i = 0; i < 4; ++i) checksum = (checksum << 8) | reader.bits(8);
+		return !reader.overrun() && (checksum == adler32::hash(out.data() + start, out.size() - start));
+	}
+
+private:
+	static constexpr std::size_t window_size = 32768;
+	static constexpr int fast_bits = 9;
+	static constexpr std::size_t hash_size = 1 << 15;
+	static constexpr std::size_t min_match = 3;
+	static constexpr std::size_t max_match = 258;
+
+	struct bit_writer {
+		std::vector<byte> &out;
+		std::uint32_t bits = 0;
+		int count = 0;
+
+		void put(std::uint32_t value, int n) {
+			bits |= value << count;
+			count += n;
+			while (count >= 8) {
+				out.push_back(static_cast<byte>(bits));
+				bits >>= 8;
+				count -= 8;
+			}
+		}
+
+		void flush() {
+			if (count > 0) out.push_back(static_cast<byte>(bits));
+			bits = 0;
+			count = 0;
+		}
+	};
+
+	struct bit_reader {
+		const byte *data;
+		std::size_t size;
+		std::size_t position = 0;
+		std::uint64_t buffer = 0;
+		int count = 0;
+		std::size_t padding = 0;
+
+		void fill() noexcept {
+			while (count <= 56) {
+				if (position < size) {
+					buffer |= static_cast<std::uint64_t>(data[position++]) << count;
+				} else {
+					++padding;
+				}
+				count += 8;
+			}
+		}
+
+		std::uint32_t peek(int n) noexcept {
+			if (count < n) fill();
+			return static_cast<std::uint32_t>(buffer & ((1ULL << n) - 1));
+		}
+
+		void skip(int n) noexcept {
+			buffer >>= n;
+			count -= n;
+		}
+
+		std::uint32_t bits(int n) noexcept {
+			if (n == 0) return 0;
+
+			auto result = peek(n);
+			skip(n);
+			return result;
+		}
+
+		void align() noexcept { skip(count % 8); }
+
+		bool overrun() const noexcept { return (padding * 8 > static_cast<std::size_t>(count)); }
+	};
+
+	struct huffman {
+		std::uint16_t count[16];
+		std::uint16_t symbol[288];
+		std::uint16_t fast[1 << fast_bits];
+	};
+
+	static bool build(huffman &h, const byte *lengths, int n) noexcept {
+		std::fill(std::begin(h.count), std::end(h.count), 0);
+		std::fill(std::begin(h.fast), std::end(h.fast), 0);
+		for (int i = 0; i < n; ++i) ++h.count[lengths[i]];
+		h.count[0] = 0;
+
+		int left = 1;
+		for (int length = 1; length < 16; ++length) {
+			left = (left << 1) - h.count[length];
+			if (left < 0) return false;
+		}
+
+		std::uint16_t offsets[16];
+		std::uint16_t codes[16];
+		offsets[1] = 0;
+		codes[1] = 0;
+		for (int length = 1; length < 15; ++length) {
+			offsets[length + 1] = offsets[length] + h.count[length];
+			codes[length + 1] = static_cast<std::uint16_t>((codes[length] + h.count[length]) << 1);
+		}
+
+		for (int i = 0; i < n; ++i) {
+			auto length = lengths[i];
+			if (length == 0) continue;
+
+			h.symbol[offsets[length]++] = static_cast<std::uint16_t>(i);
+			auto code = codes[length]++;
+			if (length > fast_bits) continue;
+
+			auto reversed = reverse(code, length);
+			for (std::uint32_t fill = reversed; fill < (1U << fast_bits); fill += (1U << length)) {
+				h.fast[fill] = static_cast<std::uint16_t>((i << 4) | length);
+			}
+		}
+		return true;
+	}
+
+	static int decode(bit_reader &reader, const huffman &h) noexcept {
+		auto entry = h.fast[reader.peek(15) & ((1U << fast_bits) - 1)];
+		if (entry != 0) {
+			reader.skip(entry & 0x0F);
+			return entry >> 4;
+		}
+
+		int code = 0;
+		int first = 0;
+		int index = 0;
+		for (int length = 1; length < 16; ++length) {
+			code |= static_cast<int>(reader.bits(1));
+			int count = h.count[length];
+			if (code - count < first) return h.symbol[index + (code - first)];
+
+			index += count;
+			first = (first + count) << 1;
+			code <<= 1;
+		}
+		return -1;
+	}
+
+	static void fixed(huffman &literals, huffman &distances) noexcept {
+		byte lengths[288];
+		std::fill(lengths, lengths + 144, 8);
+		std::fill(lengths + 144, lengths + 256, 9);
+		std::fill(lengths + 256, lengths + 280, 7);
+		std::fill(lengths + 280, lengths + 288, 8);
+		build(literals, lengths, 288);
+
+		std::fill(lengths, lengths + 30, 5);
+		build(distances, lengths, 30);
+	}
+
+	static bool dynamic(bit_reader &reader, huffman &literals, huffman &distances) noexcept {
+		static const byte order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		int nlen = static_cast<int>(reader.bits(5)) + 257;
+		int ndist = static_cast<int>(reader.bits(5)) + 1;
+		int ncode = static_cast<int>(reader.bits(4)) + 4;
+		if ((nlen > 286) || (ndist > 30)) return false;
+
+		byte lengths[320] = {};
+		for (int i = 0; i < ncode; ++i) lengths[order[i]] = static_cast<byte>(reader.bits(3));
+
+		huffman lencode;
+		if (!build(lencode, lengths, 19)) return false;
+
+		int index = 0;
+		while (index < nlen + ndist) {
+			auto symbol = decode(reader, lencode);
+			if (symbol < 0) return false;
+
+			if (symbol < 16) {
+				lengths[index++] = static_cast<byte>(symbol);
+				continue;
+			}
+
+			byte value = 0;
+			int repeat;
+			if (symbol == 16) {
+				if (index == 0) return false;
+				value = lengths[index - 1];
+				repeat = 3 + static_cast<int>(reader.bits(2));
+			} else if (symbol == 17) {
+				repeat = 3 + static_cast<int>(reader.bits(3));
+			} else {
+				repeat = 11 + static_cast<int>(reader.bits(7));
+			}
+			if (index + repeat > nlen + ndist) return false;
+			while (repeat-- > 0) lengths[index++] = value;
+		}
+
+		if (lengths[256] == 0) return false;
+		return build(literals, lengths, nlen) && build(distances, lengths + nlen, ndist) && !reader.overrun();
+	}
+
+	static bool stored(bit_reader &reader, std::vector<byte> &out, std::size_t end) {
+		reader.align();
+		auto length = reader.bits(16);
+		auto complement = reader.bits(16);
+		if (((length ^ 0xFFFF) != complement) || (length > end - out.size())) return false;
+
+		while ((length > 0) && (reader.count > 0)) {
+			out.push_back(static_cast<byte>(reader.bits(8)));
+			--length;
+		}
+		if (reader.position + length > reader.size) return false;
+
+		out.insert(out.end(), reader.data + reader.position, reader.data + reader.position + length);
+		reader.position += length;
+		return true;
+	}
+
+	static bool inflate(bit_reader &reader, const huffman &literals, const huffman &distances, std::vector<byte> &out, std::size_t start, std::size_t end) {
+		while (true) {
+			auto symbol = decode(reader, literals);
+			if ((symbol < 0) || reader.overrun()) return false;
+
+			if (symbol < 256) {
+				if (out.size() == end) return false;
+				out.push_back(static_cast<byte>(symbol));
+				continue;
+			}
+			if (symbol == 256) return true;
+
+			symbol -= 257;
+			if (symbol >= 29) return false;
+			std::size_t length = length_base()[symbol] + reader.bits(length_extra()[symbol]);
+
+			symbol = decode(reader, distances);
+			if ((symbol < 0) || (symbol >= 30)) return false;
+			std::size_t distance = distance_base()[symbol] + reader.bits(distance_extra()[symbol]);
+			if ((distance > out.size() - start) || (length > end - out.size()) || reader.overrun()) return false;
+
+			auto from = out.size() - distance;
+			out.resize(out.size() + length);
+			auto p = out.data();
+			for (std::size_t i = 0; i < length; ++i) p[out.size() - length + i] = p[from + i];
+		}
+	}
+
+	static const std::uint16_t *length_base() noexcept {
+		static const std::uint16_t values[] = {
+			3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+			35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+		};
+		return values;
+	}
+
+	static const byte *length_extra() noexcept {
+		static const byte values[] = {
+			0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+			3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+		};
+		return values;
+	}
+
+	static const std::uint16_t *distance_base() noexcept {
+		static const std::uint16_t values[] = {
+			1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+			257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+		};
+		return values;
+	}
+
+	static const byte *distance_extra() noexcept {
+		static const byte values[] = {
+			0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+			7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+		};
+		return values;
+	}
+
+	static std::uint32_t reverse(std::uint32_t code, int length) noexcept {
+		std::uint32_t result = 0;
+		for (int i = 0; i < length; ++i, code >>= 1) result = (result << 1) | (code & 1);
+		return result;
+	}
+
+	static void literal(bit_writer &writer, std::uint32_t symbol) {
+		if (symbol < 144) {
+			writer.put(reverse(0x30 + symbol, 8), 8);
+		} else if (symbol < 256) {
+			writer.put(reverse(0x190 + symbol - 144, 9), 9);
+		} else if (symbol < 280) {
+			writer.put(reverse(symbol - 256, 7), 7);
+		} else {
+			writer.put(reverse(0xC0 + symbol - 280, 8), 8);
+		}
+	}
+
+	static void match(bit_writer &writer, std::size_t length, std::size_t distance) {
+		int index = 28;
+		while (length_base()[index] > length) --index;
+		literal(writer, 257 + index);
+		writer.put(static_cast<std::uint32_t>(length - length_base()[index]), length_extra()[index]);
+
+		index = 29;
+		while (distance_base()[index] > distance) --index;
+		writer.put(reverse(static_cast<std::uint32_t>(index), 5), 5);
+		writer.put(static_cast<std::uint32_t>(distance - distance_base()[index]), distance_extra()[index]);
+	}
+
+	static std::size_t hash(const byte *p) noexcept {
+		auto value = (static_cast<std::uint32_t>(p[0]) << 16) | (static_cast<std::uint32_t>(p[1]) << 8) | p[2];
+		return ((value * 2654435761U) >> 17) & (hash_size - 1);
+	}
+
+	static void encode(const byte *data, std::size_t size, bit_writer &writer, int effort) {
+		std::vector<std::ptrdiff_t> head(hash_size, -1);
+		std::vector<std::ptrdiff_t> previous(window_size, -1);
+
+		auto insert = [&](std::size_t position) {
+			if (position + min_match > size) return;
+
+			auto &h = head[hash(data + position)];
+			previous[position & (window_size - 1)] = h;
+			h = static_cast<std::ptrdiff_t>(position);
+		};
+
+		std::size_t i = 0;
+		while (i < size) {
+			std::size_t best_length = 0;
+			std::size_t best_distance = 0;
+
+			if (i + min_match <= size) {
+				auto limit = (size - i < max_match) ? (size - i) : max_match;
+				auto candidate = head[hash(data + i)];
+				for (int chain = effort; (candidate >= 0) && (chain > 0); --chain) {
+					auto position = static_cast<std::size_t>(candidate);
+					if (i - position > window_size) break;
+
+					std::size_t length = 0;
+					while ((length < limit) && (data[position + length] == data[i + length])) ++length;
+					if (length > best_length) {
+						best_length = length;
+						best_distance = i - position;
+						if (length == limit) break;
+					}
+
+					auto next = previous[position & (window_size - 1)];
+					if (next >= candidate) break;
+					candidate = next;
+				}
+			}
+
+			if (best_length >= min_match) {
+				match(writer, best_length, best_distance);
+				for (std::size_t n = 0; n < best_length; ++n) insert(i + n);
+				i += best_length;
+			} else {
+				literal(writer, data[i]);
+				insert(i);
+				++i;
+			}
+		}
+	}
+
+	static void store(const byte *data, std::size_t size, std::vector<byte> &out) {
+		do {
+			auto block = std::min<std::size_t>(size, 0xFFFF);
+			size -= block;
+			out.push_back((size == 0) ? 1 : 0);
+			out.push_back(static_cast<byte>(block));
+			out.push_back(static_cast<byte>(block >> 8));
+			out.push_back(static_cast<byte>(~block));
+			out.push_back(static_cast<byte>(~block >> 8));
+			out.insert(out.end(), data, data + block);
+			data += block;
+		} while (size > 0);
+	}
+};
+
+} } // namespace sdl::detail
+
+#endif // SDL2_WRAPPER_DETAIL_ZLIB_HPP_
@@ -27,6 +27,9 @@
 #include "event/event_category.hpp"
 #include "event/event.hpp"
 #include "event/event_handler.hpp"
+#include "event/event_record.hpp"
+#include "event/event_recorder.hpp"
+#include "event/event_player.hpp"
 
 // SDL_scancode.h
 #include "event/scancode.hpp"
@@ -50,5 +53,8 @@
 // SDL_haptic.h
 #include "event/haptic.hpp"
 
+// input state
+#include "event/input_snapshot.hpp"
+
 #endif // SDL2_WRAPPER_EVENT_HPP_
 
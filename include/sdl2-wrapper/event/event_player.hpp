@@ -0,0 +1,281 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_EVENT_EVENT_PLAYER_HPP_
+#define SDL2_WRAPPER_EVENT_EVENT_PLAYER_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace sdl { inline namespace event {
+
+class event_player final {
+public:
+	enum class timing {
+		original,
+		fast,
+	};
+
+	explicit event_player(std::vector<Uint8> data, timing mode = timing::original, std::size_t batch = 256)
+		: _data(std::move(data)), _timing(mode), _batch(batch), _frequency(SDL_GetPerformanceFrequency()) {
+		_valid = validate();
+	}
+
+	explicit event_player(SDL_RWops *src, int freesrc, timing mode = timing::original, std::size_t batch = 256)
+		: event_player(read(src, freesrc), mode, batch) {}
+
+	explicit event_player(const char *path, timing mode = timing::original, std::size_t batch = 256)
+		: event_player(SDL_RWFromFile(path, "rb"), 1, mode, batch) {}
+
+	event_player(const event_player &) = delete;
+
+	event_player &operator =(const event_player &) = delete;
+
+	bool valid() const noexcept { return _valid; }
+
+	std::size_t size() const noexcept { return _count; }
+
+	std::size_t position() const noexcept { return _position; }
+
+	bool finished() const noexcept { return (_position >= _count); }
+
+	// Length of the recording in microseconds.
+	Uint64 duration() const noexcept { return _duration; }
+
+	timing mode() const noexcept { return _timing; }
+
+	void mode(timing mode) noexcept { _timing = mode; }
+
+	void rewind() noexcept {
+		_cursor = records();
+		_position = 0;
+		_time = 0;
+		_started = false;
+	}
+
+	// Decodes the next record without pushing it. Drop events own a copy of
+	// their text allocated with SDL_malloc, as if SDL had produced them.
+	bool next(SDL_Event &event, Uint64 *time = nullptr) noexcept {
+		if (!_valid || finished()) return false;
+
+		auto cursor = _cursor;
+		Uint64 delta, type, length;
+		if (!event_record::get(cursor, strings(), delta)
+			|| !event_record::get(cursor, strings(), type)
+			|| !event_record::get(cursor, strings(), length)
+			|| (length > static_cast<Uint64>(strings() - cursor))) {
+			return fail();
+		}
+
+		std::memset(&event, 0, sizeof(event));
+		event.type = static_cast<Uint32>(type);
+
+		auto bytes = reinterpret_cast<Uint8 *>(&event);
+		auto room = sizeof(event) - event_record::skipped;
+
+		event_record::text_field field;
+		if (event_record::text(event.type, field)) {
+			auto count = static_cast<std::size_t>(std::min<Uint64>(length, room - field.size));
+			auto head = std::min<std::size_t>(field.offset - event_record::skipped, count);
+			std::memcpy(bytes + event_record::skipped, cursor, head);
+			std::memcpy(bytes + field.offset + field.size, cursor + head, count - head);
+			cursor += length;
+
+			Uint64 reference;
+			if (!event_record::get(cursor, strings(), reference)) return fail();
+			if (!restore(event, field, reference)) return false;
+		} else {
+			auto count = static_cast<std::size_t>(std::min<Uint64>(length, room));
+			std::memcpy(bytes + event_record::skipped, cursor, count);
+			cursor += length;
+		}
+
+		_cursor = cursor;
+		_time += delta;
+		++_position;
+		if (time != nullptr) *time = _time;
+		return true;
+	}
+
+	// Pushes the records that are due. With timing::original the recording
+	// clock starts at the first call; timing::fast pushes up to one batch of
+	// records per call regardless of time. Returns the number pushed; a
+	// filtered event is released and skipped, a full queue ends the call.
+	std::size_t update() noexcept {
+		if (!_valid) return 0;
+
+		auto now = SDL_GetPerformanceCounter();
+		if (!_started) {
+			_origin = now;
+			_started = true;
+		}
+		auto elapsed = event_record::microseconds(now - _origin, _frequency);
+
+		std::size_t pushed = 0;
+		while (!finished() && (pushed < _batch)) {
+			if ((_timing == timing::original) && (due() > elapsed)) break;
+
+			SDL_Event event;
+			if (!next(event)) break;
+
+			// SDL_PushEvent returns 0 when filtered and a negative value on
+			// error; SDL only takes ownership of the text on success
+			auto result = SDL_PushEvent(&event);
+			if (result != 1) {
+				release(event);
+				if (result < 0) break;
+				continue;
+			}
+			++pushed;
+		}
+		return pushed;
+	}
+
+	static void release(SDL_Event &event) noexcept {
+		event_record::text_field field;
+		if (!event_record::text(event.type, field) || !field.pointer) return;
+
+		char *str;
+		std::memcpy(&str, reinterpret_cast<Uint8 *>(&event) + field.offset, sizeof(str));
+		SDL_free(str);
+		str = nullptr;
+		std::memcpy(reinterpret_cast<Uint8 *>(&event) + field.offset, &str, sizeof(str));
+	}
+
+private:
+	static std::vector<Uint8> read(SDL_RWops *src, int freesrc) noexcept {
+		std::vector<Uint8> result;
+		if (src == nullptr) return result;
+
+		try {
+			auto size = SDL_RWsize(src);
+			if (size > 0) {
+				result.resize(static_cast<std::size_t>(size));
+				if (SDL_RWread(src, result.data(), 1, result.size()) != result.size()) result.clear();
+			}
+		} catch (...) {
+			result.clear();
+		}
+		if (freesrc != 0) SDL_RWclose(src);
+		return result;
+	}
+
+	const Uint8 *records() const noexcept { return _data.data() + sizeof(event_record::header); }
+
+	const Uint8 *strings() const noexcept { return _data.data() + _data.size() - _strings; }
+
+	bool fail() noexcept {
+		_valid = false;
+		SDL_SetError("corrupt event record");
+		return false;
+	}
+
+	// Walks the stream once so playback never meets a truncated record.
+	bool validate() noexcept {
+		event_record::header header;
+		if (!event_record::read_header(_data.data(), _data.size(), header)) return false;
+
+		_strings = header.strings;
+		_count = header.records;
+		_cursor = records();
+
+		auto cursor = records();
+		for (Uint32 i = 0; i < header.records; ++i) {
+			Uint64 delta, type, length, reference;
+			if (!event_record::get(cursor, strings(), delta)
+				|| !event_record::get(cursor, strings(), type)
+				|| !event_record::get(cursor, strings(), length)
+				|| (length > static_cast<Uint64>(strings() - cursor))) {
+				SDL_SetError("event recording is truncated");
+				return false;
+			}
+			cursor += length;
+
+			event_record::text_field field;
+			if (event_record::text(static_cast<Uint32>(type), field)) {
+				if (!event_record::get(cursor, strings(), reference) || (reference > _strings)) {
+					SDL_SetError("event recording is truncated");
+					return false;
+				}
+			}
+			_duration += delta;
+		}
+		if ((_strings != 0) && (strings()[_strings - 1] != 0)) {
+			SDL_SetError("event recording string table is not terminated");
+			return false;
+		}
+		return true;
+	}
+
+	Uint64 due() const noexcept {
+		auto cursor = _cursor;
+		Uint64 delta = 0;
+		event_record::get(cursor, strings(), delta);
+		return _time + delta;
+	}
+
+	bool restore(SDL_Event &event, const event_record::text_field &field, Uint64 reference) noexcept {
+		auto bytes = reinterpret_cast<Uint8 *>(&event) + field.offset;
+		if (reference == 0) return true;
+		if (reference > _strings) return false;
+
+		auto str = reinterpret_cast<const char *>(strings()) + reference - 1;
+		auto length = std::strlen(str);
+		if (!field.pointer) {
+			auto count = std::min(length, field.size - 1);
+			std::memcpy(bytes, str, count);
+			bytes[count] = 0;
+			return true;
+		}
+
+		auto copy = static_cast<char *>(SDL_malloc(length + 1));
+		if (copy == nullptr) {
+			SDL_SetError("out of memory");
+			return false;
+		}
+		std::memcpy(copy, str, length + 1);
+		std::memcpy(bytes, &copy, sizeof(copy));
+		return true;
+	}
+
+private:
+	std::vector<Uint8> _data;
+	timing _timing;
+	const std::size_t _batch;
+	const Uint64 _frequency;
+	bool _valid = false;
+
+	std::size_t _strings = 0;
+	std::size_t _count = 0;
+	std::size_t _position = 0;
+	const Uint8 *_cursor = nullptr;
+	Uint64 _time = 0;
+	Uint64 _duration = 0;
+
+	bool _started = false;
+	Uint64 _origin = 0;
+};
+
+} } // namespace sdl::event
+
+#endif // SDL2_WRAPPER_EVENT_EVENT_PLAYER_HPP_
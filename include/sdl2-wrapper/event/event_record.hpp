@@ -0,0 +1,161 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_EVENT_EVENT_RECORD_HPP_
+#define SDL2_WRAPPER_EVENT_EVENT_RECORD_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace sdl { inline namespace event {
+
+// Shared encoding of event_recorder and event_player.
+//
+// A recording is a header followed by the record stream and a string table.
+// Each record is a varint time delta in microseconds, a varint event type,
+// a varint payload length and the bytes of the event past its type and
+// timestamp. Text carried by the event is cut out of the payload and
+// replaced by a varint reference into the string table (offset + 1, or 0).
+struct event_record final {
+	static constexpr Uint32 magic = 0x52564553; // "SEVR"
+	static constexpr Uint32 version = 1;
+	static constexpr std::size_t skipped = offsetof(SDL_CommonEvent, timestamp) + sizeof(Uint32);
+
+	struct header {
+		Uint32 magic;
+		Uint32 version;
+		Uint32 records;
+		Uint32 strings;
+	};
+
+	struct text_field {
+		std::size_t offset;
+		std::size_t size;
+		bool pointer;
+	};
+
+	// Bytes of SDL_Event that are meaningful for the given type.
+	static std::size_t size(Uint32 type) noexcept {
+		switch (type) {
+		case SDL_WINDOWEVENT: return sizeof(SDL_WindowEvent);
+		case SDL_KEYDOWN: case SDL_KEYUP: return sizeof(SDL_KeyboardEvent);
+		case SDL_TEXTEDITING: return sizeof(SDL_TextEditingEvent);
+		case SDL_TEXTINPUT: return sizeof(SDL_TextInputEvent);
+		case SDL_MOUSEMOTION: return sizeof(SDL_MouseMotionEvent);
+		case SDL_MOUSEBUTTONDOWN: case SDL_MOUSEBUTTONUP: return sizeof(SDL_MouseButtonEvent);
+		case SDL_MOUSEWHEEL: return sizeof(SDL_MouseWheelEvent);
+		case SDL_JOYAXISMOTION: return sizeof(SDL_JoyAxisEvent);
+		case SDL_JOYBALLMOTION: return sizeof(SDL_JoyBallEvent);
+		case SDL_JOYHATMOTION: return sizeof(SDL_JoyHatEvent);
+		case SDL_JOYBUTTONDOWN: case SDL_JOYBUTTONUP: return sizeof(SDL_JoyButtonEvent);
+		case SDL_JOYDEVICEADDED: case SDL_JOYDEVICEREMOVED: return sizeof(SDL_JoyDeviceEvent);
+		case SDL_CONTROLLERAXISMOTION: return sizeof(SDL_ControllerAxisEvent);
+		case SDL_CONTROLLERBUTTONDOWN: case SDL_CONTROLLERBUTTONUP: return sizeof(SDL_ControllerButtonEvent);
+		case SDL_CONTROLLERDEVICEADDED: case SDL_CONTROLLERDEVICEREMOVED: case SDL_CONTROLLERDEVICEREMAPPED: return sizeof(SDL_ControllerDeviceEvent);
+		case SDL_FINGERDOWN: case SDL_FINGERUP: case SDL_FINGERMOTION: return sizeof(SDL_TouchFingerEvent);
+		case SDL_DOLLARGESTURE: case SDL_DOLLARRECORD: return sizeof(SDL_DollarGestureEvent);
+		case SDL_MULTIGESTURE: return sizeof(SDL_MultiGestureEvent);
+		case SDL_DROPFILE: case SDL_DROPTEXT: case SDL_DROPBEGIN: case SDL_DROPCOMPLETE: return sizeof(SDL_DropEvent);
+		case SDL_AUDIODEVICEADDED: case SDL_AUDIODEVICEREMOVED: return sizeof(SDL_AudioDeviceEvent);
+		case SDL_QUIT:
+		case SDL_APP_TERMINATING: case SDL_APP_LOWMEMORY:
+		case SDL_APP_WILLENTERBACKGROUND: case SDL_APP_DIDENTERBACKGROUND:
+		case SDL_APP_WILLENTERFOREGROUND: case SDL_APP_DIDENTERFOREGROUND:
+		case SDL_KEYMAPCHANGED: case SDL_CLIPBOARDUPDATE:
+		case SDL_RENDER_TARGETS_RESET: case SDL_RENDER_DEVICE_RESET:
+			return sizeof(SDL_CommonEvent);
+		default:
+			return (type >= SDL_USEREVENT) ? sizeof(SDL_UserEvent) : sizeof(SDL_Event);
+		}
+	}
+
+	static bool text(Uint32 type, text_field &field) noexcept {
+		switch (type) {
+		case SDL_TEXTEDITING:
+			field = text_field { offsetof(SDL_TextEditingEvent, text), sizeof(SDL_TextEditingEvent::text), false };
+			return true;
+		case SDL_TEXTINPUT:
+			field = text_field { offsetof(SDL_TextInputEvent, text), sizeof(SDL_TextInputEvent::text), false };
+			return true;
+		case SDL_DROPFILE: case SDL_DROPTEXT:
+			field = text_field { offsetof(SDL_DropEvent, file), sizeof(SDL_DropEvent::file), true };
+			return true;
+#if SDL_VERSION_ATLEAST(2, 0, 22)
+		case SDL_TEXTEDITING_EXT:
+			field = text_field { offsetof(SDL_TextEditingExtEvent, text), sizeof(SDL_TextEditingExtEvent::text), true };
+			return true;
+#endif
+		default:
+			return false;
+		}
+	}
+
+	// Converts performance counter ticks to microseconds. Whole seconds are
+	// scaled separately so the product cannot overflow on long sessions.
+	static Uint64 microseconds(Uint64 ticks, Uint64 frequency) noexcept {
+		return ticks / frequency * 1000000 + ticks % frequency * 1000000 / frequency;
+	}
+
+	// Events whose payload only makes sense inside the recording process.
+	static bool recordable(Uint32 type) noexcept { return (type != SDL_SYSWMEVENT); }
+
+	static void put(std::vector<Uint8> &out, Uint64 value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<Uint8>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<Uint8>(value));
+	}
+
+	static bool get(const Uint8 *&data, const Uint8 *end, Uint64 &value) noexcept {
+		value = 0;
+		for (int shift = 0; (data < end) && (shift < 64); shift += 7) {
+			auto byte = *data++;
+			value |= static_cast<Uint64>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) return true;
+		}
+		return false;
+	}
+
+	static void write_header(std::vector<Uint8> &out, Uint32 records, Uint32 strings) {
+		header h { magic, version, records, strings };
+		auto bytes = reinterpret_cast<const Uint8 *>(&h);
+		out.insert(out.end(), bytes, bytes + sizeof(h));
+	}
+
+	static bool read_header(const Uint8 *data, std::size_t size, header &result) noexcept {
+		if (size < sizeof(result)) {
+			SDL_SetError("event recording is truncated");
+			return false;
+		}
+		std::memcpy(&result, data, sizeof(result));
+		if ((result.magic != magic) || (result.version != version) || (result.strings > size - sizeof(result))) {
+			SDL_SetError("not an event recording");
+			return false;
+		}
+		return true;
+	}
+};
+
+} } // namespace sdl::event
+
+#endif // SDL2_WRAPPER_EVENT_EVENT_RECORD_HPP_
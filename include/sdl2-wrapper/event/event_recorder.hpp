@@ -0,0 +1,222 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_EVENT_EVENT_RECORDER_HPP_
+#define SDL2_WRAPPER_EVENT_EVENT_RECORDER_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sdl { inline namespace event {
+
+class event_recorder final {
+public:
+	struct statistics {
+		Uint64 records = 0;
+		Uint64 skipped = 0;
+		Uint64 bytes = 0;
+		Uint64 strings = 0;
+	};
+
+	event_recorder() : _frequency(SDL_GetPerformanceFrequency()) {}
+
+	event_recorder(const event_recorder &) = delete;
+
+	event_recorder &operator =(const event_recorder &) = delete;
+
+	~event_recorder() { stop(); }
+
+	// Watches every event entering the queue, including pushed ones.
+	// The watcher is (un)registered outside of the recorder lock: SDL holds
+	// its own watcher lock while calling record(), possibly on another thread.
+	void start() noexcept {
+		if (_recording.exchange(true)) return;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_started) {
+				_origin = SDL_GetPerformanceCounter();
+				_started = true;
+			}
+		}
+		event_handler::add_watcher(&event_recorder::watch, this);
+	}
+
+	void stop() noexcept {
+		if (!_recording.exchange(false)) return;
+
+		event_handler::delete_watcher(&event_recorder::watch, this);
+	}
+
+	bool recording() const noexcept { return _recording.load(); }
+
+	void clear() noexcept {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_records.clear();
+		_strings.clear();
+		_string_offsets.clear();
+		_count = 0;
+		_previous = 0;
+		_started = _recording.load();
+		_origin = SDL_GetPerformanceCounter();
+		_stats = statistics();
+	}
+
+	bool record(const SDL_Event &event) noexcept {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_started) {
+			_origin = SDL_GetPerformanceCounter();
+			_started = true;
+		}
+		if (!event_record::recordable(event.type)) {
+			++_stats.skipped;
+			return false;
+		}
+
+		auto size = _records.size();
+		auto strings = _strings.size();
+		try {
+			append(event);
+		} catch (...) {
+			_records.resize(size);
+			_strings.resize(strings);
+			++_stats.skipped;
+			return false;
+		}
+
+		++_count;
+		++_stats.records;
+		return true;
+	}
+
+	std::vector<Uint8> data() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		std::vector<Uint8> result;
+		result.reserve(sizeof(event_record::header) + _records.size() + _strings.size());
+		event_record::write_header(result, _count, static_cast<Uint32>(_strings.size()));
+		result.insert(result.end(), _records.begin(), _records.end());
+		result.insert(result.end(), _strings.begin(), _strings.end());
+		return result;
+	}
+
+	bool save(SDL_RWops *dst, int freedst) const noexcept {
+		if (dst == nullptr) return false;
+
+		bool result = false;
+		try {
+			auto bytes = data();
+			result = (SDL_RWwrite(dst, bytes.data(), 1, bytes.size()) == bytes.size());
+		} catch (...) {
+			SDL_SetError("out of memory");
+		}
+		if (freedst != 0) SDL_RWclose(dst);
+		return result;
+	}
+
+	bool save(const char *path) const noexcept { return save(SDL_RWFromFile(path, "wb"), 1); }
+
+	statistics stats() const noexcept {
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto result = _stats;
+		result.bytes = sizeof(event_record::header) + _records.size() + _strings.size();
+		result.strings = _strings.size();
+		return result;
+	}
+
+private:
+	static int SDLCALL watch(void *userdata, SDL_Event *event) {
+		static_cast<event_recorder *>(userdata)->record(*event);
+		return 0;
+	}
+
+	void append(const SDL_Event &event) {
+		auto now = event_record::microseconds(SDL_GetPerformanceCounter() - _origin, _frequency);
+		auto delta = (now > _previous) ? (now - _previous) : 0;
+		_previous = std::max(now, _previous);
+
+		auto bytes = reinterpret_cast<const Uint8 *>(&event);
+		auto size = event_record::size(event.type);
+
+		event_record::text_field field;
+		bool has_text = event_record::text(event.type, field);
+		auto length = size - event_record::skipped - (has_text ? field.size : 0);
+
+		event_record::put(_records, delta);
+		event_record::put(_records, event.type);
+		event_record::put(_records, length);
+		if (has_text) {
+			_records.insert(_records.end(), bytes + event_record::skipped, bytes + field.offset);
+			_records.insert(_records.end(), bytes + field.offset + field.size, bytes + size);
+			event_record::put(_records, intern(event, field));
+		} else {
+			_records.insert(_records.end(), bytes + event_record::skipped, bytes + size);
+		}
+	}
+
+	// Returns the string table reference of the event text, sharing
+	// repeated strings.
+	Uint32 intern(const SDL_Event &event, const event_record::text_field &field) {
+		auto str = reinterpret_cast<const char *>(&event) + field.offset;
+		std::size_t length;
+		if (field.pointer) {
+			std::memcpy(&str, str, sizeof(str));
+			if (str == nullptr) return 0;
+			length = std::strlen(str);
+		} else {
+			auto end = static_cast<const char *>(std::memchr(str, 0, field.size));
+			length = (end != nullptr) ? static_cast<std::size_t>(end - str) : field.size;
+		}
+
+		std::string key(str, length);
+		auto it = _string_offsets.find(key);
+		if (it != _string_offsets.end()) return it->second;
+
+		auto reference = static_cast<Uint32>(_strings.size() + 1);
+		_strings.insert(_strings.end(), str, str + length);
+		_strings.push_back(0);
+		_string_offsets.emplace(std::move(key), reference);
+		return reference;
+	}
+
+private:
+	const Uint64 _frequency;
+	Uint64 _origin = 0;
+	Uint64 _previous = 0;
+	bool _started = false;
+	std::atomic<bool> _recording { false };
+
+	mutable std::mutex _mutex;
+	std::vector<Uint8> _records;
+	std::vector<Uint8> _strings;
+	std::unordered_map<std::string, Uint32> _string_offsets;
+	Uint32 _count = 0;
+	statistics _stats;
+};
+
+} } // namespace sdl::event
+
+#endif // SDL2_WRAPPER_EVENT_EVENT_RECORDER_HPP_
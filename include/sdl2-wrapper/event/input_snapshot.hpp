@@ -0,0 +1,374 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_EVENT_INPUT_SNAPSHOT_HPP_
+#define SDL2_WRAPPER_EVENT_INPUT_SNAPSHOT_HPP_
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace sdl { inline namespace event {
+
+class input_snapshot final {
+public:
+	struct axis_change {
+		Uint16 device;
+		Uint16 axis;
+		Sint16 value;
+		Sint32 delta;
+	};
+
+	explicit input_snapshot(Sint16 threshold = 0) : _threshold(threshold) {}
+
+	// Reads every open joystick once. Devices opened as game controllers are
+	// captured through their mapping, so axis and button indices follow
+	// game_controller::axis_type and game_controller::button_type.
+	bool capture(bool update = false) noexcept {
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+		try {
+#if SDL_VERSION_ATLEAST(2, 0, 7)
+			SDL_LockJoysticks();
+#endif
+			if (update) SDL_JoystickUpdate();
+
+			std::swap(_buttons, _previous_buttons);
+			std::swap(_hats, _previous_hats);
+			if (enumerate()) relayout();
+			read();
+
+#if SDL_VERSION_ATLEAST(2, 0, 7)
+			SDL_UnlockJoysticks();
+#endif
+		} catch (...) {
+#if SDL_VERSION_ATLEAST(2, 0, 7)
+			SDL_UnlockJoysticks();
+#endif
+			discard();
+			SDL_SetError("out of memory");
+			return false;
+		}
+
+		compare();
+		++_frame;
+		return true;
+#else
+		(void)update;
+		SDL_SetError("input_snapshot requires SDL 2.0.6");
+		return false;
+#endif
+	}
+
+	Uint64 frame() const noexcept { return _frame; }
+
+	Sint16 threshold() const noexcept { return _threshold; }
+
+	void threshold(Sint16 value) noexcept { _threshold = value; }
+
+	std::size_t devices() const noexcept { return _ids.size(); }
+
+	int find(joystick::id id) const noexcept {
+		auto it = std::find(_ids.begin(), _ids.end(), id);
+		return (it != _ids.end()) ? static_cast<int>(it - _ids.begin()) : -1;
+	}
+
+	joystick::id id(std::size_t device) const noexcept { return _ids[device]; }
+
+	bool controller(std::size_t device) const noexcept { return (_controllers[device] != nullptr); }
+
+	int axes(std::size_t device) const noexcept { return _axis_count[device]; }
+
+	int buttons(std::size_t device) const noexcept { return _button_count[device]; }
+
+	int hats(std::size_t device) const noexcept { return _hat_count[device]; }
+
+	const Sint16 *axis_data(std::size_t device) const noexcept { return _axes.data() + _axis_offset[device]; }
+
+	Sint16 axis(std::size_t device, int axis) const noexcept {
+		return ((axis >= 0) && (axis < _axis_count[device])) ? _axes[_axis_offset[device] + axis] : 0;
+	}
+
+	Sint16 axis(std::size_t device, game_controller::axis_type axis) const noexcept {
+		return this->axis(device, static_cast<int>(axis));
+	}
+
+	joystick::hat_state hat(std::size_t device, int hat) const noexcept {
+		if ((hat < 0) || (hat >= _hat_count[device])) return joystick::hat_state::centered;
+		return static_cast<joystick::hat_state>(_hats[_hat_offset[device] + hat]);
+	}
+
+	bool hat_changed(std::size_t device, int hat) const noexcept {
+		if ((hat < 0) || (hat >= _hat_count[device])) return false;
+
+		auto i = _hat_offset[device] + hat;
+		return (_hats[i] != _previous_hats[i]);
+	}
+
+	bool button(std::size_t device, int button) const noexcept { return test(_buttons, device, button); }
+
+	bool button(std::size_t device, game_controller::button_type button) const noexcept {
+		return this->button(device, static_cast<int>(button));
+	}
+
+	bool pressed(std::size_t device, int button) const noexcept { return test(_pressed, device, button); }
+
+	bool pressed(std::size_t device, game_controller::button_type button) const noexcept {
+		return pressed(device, static_cast<int>(button));
+	}
+
+	bool released(std::size_t device, int button) const noexcept { return test(_released, device, button); }
+
+	bool released(std::size_t device, game_controller::button_type button) const noexcept {
+		return released(device, static_cast<int>(button));
+	}
+
+	Uint64 button_mask(std::size_t device, int word = 0) const noexcept { return mask(_buttons, device, word); }
+
+	Uint64 pressed_mask(std::size_t device, int word = 0) const noexcept { return mask(_pressed, device, word); }
+
+	Uint64 released_mask(std::size_t device, int word = 0) const noexcept { return mask(_released, device, word); }
+
+	bool any_pressed() const noexcept { return _any_pressed; }
+
+	// Axes that moved by more than the threshold since they were last
+	// reported; small drifts accumulate until they cross it.
+	const std::vector<axis_change> &changes() const noexcept { return _changes; }
+
+private:
+	static int words(int buttons) noexcept { return (buttons + 63) / 64; }
+
+	bool test(const std::vector<Uint64> &bits, std::size_t device, int button) const noexcept {
+		if ((button < 0) || (button >= _button_count[device])) return false;
+		return ((bits[_button_offset[device] + button / 64] >> (button % 64)) & 1) != 0;
+	}
+
+	Uint64 mask(const std::vector<Uint64> &bits, std::size_t device, int word) const noexcept {
+		return ((word >= 0) && (word < words(_button_count[device]))) ? bits[_button_offset[device] + word] : 0;
+	}
+
+	// Drops the layout after a failed capture so the next one rebuilds it.
+	void discard() noexcept {
+		_ids.clear();
+		_scratch.clear();
+		_joysticks.clear();
+		_controllers.clear();
+		_axis_offset.clear();
+		_button_offset.clear();
+		_hat_offset.clear();
+		_axis_count.clear();
+		_button_count.clear();
+		_hat_count.clear();
+		_fresh.clear();
+		_axes.clear();
+		_reported.clear();
+		_buttons.clear();
+		_previous_buttons.clear();
+		_pressed.clear();
+		_released.clear();
+		_hats.clear();
+		_previous_hats.clear();
+		_changes.clear();
+		_any_pressed = false;
+	}
+
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+	// Collects the open devices into the scratch list and reports whether
+	// the set differs from the current layout.
+	bool enumerate() {
+		_scratch.clear();
+		for (int i = 0, n = SDL_NumJoysticks(); i < n; ++i) {
+			auto id = SDL_JoystickGetDeviceInstanceID(i);
+			if ((id >= 0) && (SDL_JoystickFromInstanceID(id) != nullptr)) _scratch.push_back(id);
+		}
+
+		if (_scratch != _ids) return true;
+		for (std::size_t d = 0; d < _ids.size(); ++d) {
+			if (SDL_JoystickFromInstanceID(_ids[d]) != _joysticks[d]) return true;
+			if (SDL_GameControllerFromInstanceID(_ids[d]) != _controllers[d]) return true;
+		}
+		return false;
+	}
+
+	void relayout() {
+		std::vector<Uint64> previous_buttons;
+		std::vector<Uint8> previous_hats;
+		std::vector<Sint16> reported;
+
+		auto old_ids = std::move(_ids);
+		auto old_axis_offset = std::move(_axis_offset);
+		auto old_button_offset = std::move(_button_offset);
+		auto old_hat_offset = std::move(_hat_offset);
+		auto old_axis_count = std::move(_axis_count);
+		auto old_button_count = std::move(_button_count);
+		auto old_hat_count = std::move(_hat_count);
+
+		_ids = _scratch;
+		_joysticks.clear();
+		_controllers.clear();
+		_axis_offset.clear();
+		_button_offset.clear();
+		_hat_offset.clear();
+		_axis_count.clear();
+		_button_count.clear();
+		_hat_count.clear();
+		_fresh.clear();
+
+		int axes = 0, buttons = 0, hats = 0;
+		for (auto id : _ids) {
+			auto j = SDL_JoystickFromInstanceID(id);
+			auto c = SDL_GameControllerFromInstanceID(id);
+			int na = c ? static_cast<int>(SDL_CONTROLLER_AXIS_MAX) : std::max(SDL_JoystickNumAxes(j), 0);
+			int nb = c ? static_cast<int>(SDL_CONTROLLER_BUTTON_MAX) : std::max(SDL_JoystickNumButtons(j), 0);
+			int nh = c ? 0 : std::max(SDL_JoystickNumHats(j), 0);
+
+			_joysticks.push_back(j);
+			_controllers.push_back(c);
+			_axis_offset.push_back(axes);
+			_button_offset.push_back(buttons);
+			_hat_offset.push_back(hats);
+			_axis_count.push_back(na);
+			_button_count.push_back(nb);
+			_hat_count.push_back(nh);
+			axes += na;
+			buttons += words(nb);
+			hats += nh;
+		}
+
+		previous_buttons.assign(buttons, 0);
+		previous_hats.assign(hats, SDL_HAT_CENTERED);
+		reported.assign(axes, 0);
+
+		// Devices that keep their shape carry their state across the change;
+		// new or remapped ones start without edges.
+		for (std::size_t d = 0; d < _ids.size(); ++d) {
+			auto it = std::find(old_ids.begin(), old_ids.end(), _ids[d]);
+			auto o = static_cast<std::size_t>(it - old_ids.begin());
+			bool same = (it != old_ids.end())
+				&& (old_axis_count[o] == _axis_count[d])
+				&& (old_button_count[o] == _button_count[d])
+				&& (old_hat_count[o] == _hat_count[d]);
+			_fresh.push_back(!same);
+			if (!same) continue;
+
+			std::copy_n(_previous_buttons.begin() + old_button_offset[o], words(_button_count[d]), previous_buttons.begin() + _button_offset[d]);
+			std::copy_n(_previous_hats.begin() + old_hat_offset[o], _hat_count[d], previous_hats.begin() + _hat_offset[d]);
+			std::copy_n(_reported.begin() + old_axis_offset[o], _axis_count[d], reported.begin() + _axis_offset[d]);
+		}
+
+		_previous_buttons = std::move(previous_buttons);
+		_previous_hats = std::move(previous_hats);
+		_reported = std::move(reported);
+		_axes.resize(axes);
+		_buttons.resize(buttons);
+		_hats.resize(hats);
+		_pressed.resize(buttons);
+		_released.resize(buttons);
+	}
+
+	void read() noexcept {
+		for (std::size_t d = 0; d < _ids.size(); ++d) {
+			auto j = _joysticks[d];
+			auto c = _controllers[d];
+
+			auto axes = _axes.data() + _axis_offset[d];
+			for (int a = 0; a < _axis_count[d]; ++a) {
+				axes[a] = c ? SDL_GameControllerGetAxis(c, static_cast<SDL_GameControllerAxis>(a)) : SDL_JoystickGetAxis(j, a);
+			}
+
+			auto bits = _buttons.data() + _button_offset[d];
+			std::fill_n(bits, words(_button_count[d]), 0);
+			for (int b = 0; b < _button_count[d]; ++b) {
+				bool down = c ? (SDL_GameControllerGetButton(c, static_cast<SDL_GameControllerButton>(b)) != 0) : (SDL_JoystickGetButton(j, b) != 0);
+				bits[b / 64] |= static_cast<Uint64>(down) << (b % 64);
+			}
+
+			auto hats = _hats.data() + _hat_offset[d];
+			for (int h = 0; h < _hat_count[d]; ++h) hats[h] = SDL_JoystickGetHat(j, h);
+		}
+	}
+#endif
+
+	void compare() noexcept {
+		_changes.clear();
+		_any_pressed = false;
+
+		for (std::size_t d = 0; d < _ids.size(); ++d) {
+			auto first = _button_offset[d], last = first + words(_button_count[d]);
+			if (_fresh[d]) {
+				std::copy(_buttons.begin() + first, _buttons.begin() + last, _previous_buttons.begin() + first);
+				std::copy_n(_hats.begin() + _hat_offset[d], _hat_count[d], _previous_hats.begin() + _hat_offset[d]);
+				std::copy_n(_axes.begin() + _axis_offset[d], _axis_count[d], _reported.begin() + _axis_offset[d]);
+				_fresh[d] = false;
+			}
+
+			for (auto w = first; w < last; ++w) {
+				_pressed[w] = _buttons[w] & ~_previous_buttons[w];
+				_released[w] = _previous_buttons[w] & ~_buttons[w];
+				_any_pressed = _any_pressed || (_pressed[w] != 0);
+			}
+
+			for (int a = 0; a < _axis_count[d]; ++a) {
+				auto i = _axis_offset[d] + a;
+				auto delta = static_cast<Sint32>(_axes[i]) - _reported[i];
+				if ((delta == 0) || (std::abs(delta) <= _threshold)) continue;
+
+				try {
+					_changes.push_back(axis_change { static_cast<Uint16>(d), static_cast<Uint16>(a), _axes[i], delta });
+				} catch (...) {
+					continue;
+				}
+				_reported[i] = _axes[i];
+			}
+		}
+	}
+
+private:
+	Sint16 _threshold;
+	Uint64 _frame = 0;
+	bool _any_pressed = false;
+
+	std::vector<joystick::id> _ids;
+	std::vector<joystick::id> _scratch;
+	std::vector<SDL_Joystick *> _joysticks;
+	std::vector<SDL_GameController *> _controllers;
+	std::vector<int> _axis_offset;
+	std::vector<int> _button_offset;
+	std::vector<int> _hat_offset;
+	std::vector<int> _axis_count;
+	std::vector<int> _button_count;
+	std::vector<int> _hat_count;
+	std::vector<bool> _fresh;
+
+	std::vector<Sint16> _axes;
+	std::vector<Sint16> _reported;
+	std::vector<Uint64> _buttons;
+	std::vector<Uint64> _previous_buttons;
+	std::vector<Uint64> _pressed;
+	std::vector<Uint64> _released;
+	std::vector<Uint8> _hats;
+	std::vector<Uint8> _previous_hats;
+	std::vector<axis_change> _changes;
+};
+
+} } // namespace sdl::event
+
+#endif // SDL2_WRAPPER_EVENT_INPUT_SNAPSHOT_HPP_
@@ -27,6 +27,11 @@
 
 // SDL_rwops.h
 #include "io/file.hpp"
+#include "io/archive.hpp"
+
+// resource management
+#include "io/resource_cache.hpp"
+#include "io/asset_loader.hpp"
 
 #endif // SDL2_WRAPPER_IO_HPP_
 
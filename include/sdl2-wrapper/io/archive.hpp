@@ -0,0 +1,508 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_IO_ARCHIVE_HPP_
+#define SDL2_WRAPPER_IO_ARCHIVE_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sdl { inline namespace io {
+
+class archive final {
+public:
+	using hash_type = sdl::detail::fnv1a::value_type;
+	using size_type = Uint64;
+
+	static constexpr Uint32 magic = 0x414c4453; // "SDLA"
+	static constexpr Uint32 format_version = 1;
+	static constexpr Uint32 default_alignment = 16;
+	static constexpr std::size_t header_size = 32;
+	static constexpr std::size_t entry_header_size = 40;
+
+	enum class compression : Uint32 {
+		none = 0,
+		lz4 = 1,
+		zstd = 2,
+	};
+
+	struct codec {
+		std::function<bool (const void *src, std::size_t src_size, std::vector<Uint8> &dst)> encode;
+		std::function<bool (const void *src, std::size_t src_size, void *dst, std::size_t dst_size)> decode;
+	};
+
+	struct entry {
+		hash_type hash;
+		size_type offset;
+		size_type size;
+		size_type stored_size;
+		compression method;
+		std::string name;
+	};
+
+	static hash_type hash(const std::string &name) noexcept { return sdl::detail::fnv1a::hash(name.c_str()); }
+
+	static void register_codec(compression method, codec c) { codecs()[method] = std::move(c); }
+
+	static const codec *find_codec(compression method) {
+		auto &list = codecs();
+		auto it = list.find(method);
+		return (it != list.end()) ? &it->second : nullptr;
+	}
+
+	template <typename T>
+	static T load_le(const Uint8 *p) noexcept {
+		T result = 0;
+		for (std::size_t i = 0; i < sizeof(T); ++i) result |= static_cast<T>(static_cast<T>(p[i]) << (i * 8));
+		return result;
+	}
+
+	template <typename T>
+	static void store_le(std::vector<Uint8> &buffer, T value) {
+		for (std::size_t i = 0; i < sizeof(T); ++i) buffer.push_back(static_cast<Uint8>(value >> (i * 8)));
+	}
+
+public:
+	archive() = default;
+
+	explicit archive(const char *path) { open(path); }
+
+	explicit archive(const void *mem, std::size_t size) { open(mem, size); }
+
+	archive(const archive &) = delete;
+
+	archive(archive &&rhs) noexcept
+		: _file(std::move(rhs._file)), _memory(rhs._memory), _memory_size(rhs._memory_size), _entries(std::move(rhs._entries)), _alignment(rhs._alignment) {
+		rhs.close();
+	}
+
+	archive &operator =(const archive &) = delete;
+
+	archive &operator =(archive &&rhs) noexcept {
+		if (this != &rhs) {
+			close();
+			_file = std::move(rhs._file);
+			_memory = rhs._memory;
+			_memory_size = rhs._memory_size;
+			_entries = std::move(rhs._entries);
+			_alignment = rhs._alignment;
+			rhs.close();
+		}
+		return *this;
+	}
+
+	bool open(const char *path) {
+		close();
+		_file.reset(file::make_resource(path, "rb"));
+		if (!_file || !read_index()) {
+			close();
+		}
+		return valid();
+	}
+
+	bool open(const void *mem, std::size_t size) {
+		close();
+		_memory = static_cast<const Uint8 *>(mem);
+		_memory_size = size;
+		if ((_memory == nullptr) || !read_index()) {
+			close();
+		}
+		return valid();
+	}
+
+	void close() noexcept {
+		_file.destroy();
+		_memory = nullptr;
+		_memory_size = 0;
+		_entries.clear();
+		_alignment = 0;
+	}
+
+	bool valid() const noexcept { return (_alignment != 0); }
+
+	explicit operator bool() const noexcept { return valid(); }
+
+	Uint32 alignment() const noexcept { return _alignment; }
+
+	std::size_t size() const noexcept { return _entries.size(); }
+
+	const std::vector<entry> &entries() const noexcept { return _entries; }
+
+	const entry *find(const std::string &name) const noexcept {
+		auto h = hash(name);
+		auto it = std::lower_bound(_entries.begin(), _entries.end(), h, [](const entry &e, hash_type value) { return e.hash < value; });
+		for (; (it != _entries.end()) && (it->hash == h); ++it) {
+			if (it->name == name) return &*it;
+		}
+		return nullptr;
+	}
+
+	bool contains(const std::string &name) const noexcept { return (find(name) != nullptr); }
+
+	file open_file(const std::string &name) const {
+		auto e = find(name);
+		return (e != nullptr) ? open_file(*e) : null_file();
+	}
+
+	// Uncompressed entries of a file-backed archive are read through the
+	// archive's own SDL_RWops: the returned file must not outlive the archive.
+	// Each read seeks that shared handle first, so these views are not
+	// thread-safe; read files of one archive from a single thread at a time.
+	// Entries of a memory archive and decoded entries have no such limit.
+	file open_file(const entry &e) const {
+		if (!valid()) return null_file();
+
+		auto v = std::make_unique<view>();
+		v->base = _file.get();
+		v->begin = static_cast<Sint64>(e.offset);
+		v->size = static_cast<Sint64>(e.size);
+		v->position = 0;
+
+		if (_memory != nullptr) {
+			v->memory = _memory + e.offset;
+		}
+
+		if (e.method != compression::none) {
+			auto c = find_codec(e.method);
+			if ((c == nullptr) || !c->decode) {
+				SDL_SetError("archive: no decoder for '%s'", e.name.c_str());
+				return null_file();
+			}
+
+			std::vector<Uint8> stored;
+			const Uint8 *src = v->memory;
+			try {
+				if (src == nullptr) {
+					stored.resize(static_cast<std::size_t>(e.stored_size));
+					if (!read_at(e.offset, stored.data(), stored.size())) return null_file();
+					src = stored.data();
+				}
+				v->storage.resize(static_cast<std::size_t>(e.size));
+			} catch (...) {
+				SDL_SetError("archive: '%s' is too large", e.name.c_str());
+				return null_file();
+			}
+			if (!c->decode(src, static_cast<std::size_t>(e.stored_size), v->storage.data(), v->storage.size())) {
+				SDL_SetError("archive: failed to decode '%s'", e.name.c_str());
+				return null_file();
+			}
+			v->memory = v->storage.data();
+			v->begin = 0;
+		}
+
+		auto rw = SDL_AllocRW();
+		if (rw == nullptr) return null_file();
+
+		rw->size = view::size_fn;
+		rw->seek = view::seek_fn;
+		rw->read = view::read_fn;
+		rw->write = view::write_fn;
+		rw->close = view::close_fn;
+		rw->type = SDL_RWOPS_UNKNOWN;
+		rw->hidden.unknown.data1 = v.release();
+		rw->hidden.unknown.data2 = nullptr;
+
+		return file(file::handle_holder(rw, file::handle_closer));
+	}
+
+private:
+	struct view final {
+		SDL_RWops *base = nullptr;
+		const Uint8 *memory = nullptr;
+		Sint64 begin = 0;
+		Sint64 size = 0;
+		Sint64 position = 0;
+		std::vector<Uint8> storage;
+
+		static view *from(SDL_RWops *rw) noexcept { return static_cast<view *>(rw->hidden.unknown.data1); }
+
+		static Sint64 SDLCALL size_fn(SDL_RWops *rw) { return from(rw)->size; }
+
+		static Sint64 SDLCALL seek_fn(SDL_RWops *rw, Sint64 offset, int whence) {
+			auto v = from(rw);
+			Sint64 position = -1;
+			switch (whence) {
+			case RW_SEEK_SET: position = offset; break;
+			case RW_SEEK_CUR: position = v->position + offset; break;
+			case RW_SEEK_END: position = v->size + offset; break;
+			default: break;
+			}
+			if ((position < 0) || (position > v->size)) return SDL_SetError("archive: invalid seek");
+			return (v->position = position);
+		}
+
+		static size_t SDLCALL read_fn(SDL_RWops *rw, void *ptr, size_t size, size_t maxnum) {
+			auto v = from(rw);
+			if (size == 0) return 0;
+
+			auto num = std::min(maxnum, static_cast<size_t>(v->size - v->position) / size);
+			if (num == 0) return 0;
+
+			if (v->memory != nullptr) {
+				std::memcpy(ptr, v->memory + v->position, num * size);
+
+			} else {
+				if (SDL_RWseek(v->base, v->begin + v->position, RW_SEEK_SET) < 0) return 0;
+				num = SDL_RWread(v->base, ptr, size, num);
+			}
+
+			v->position += static_cast<Sint64>(num * size);
+			return num;
+		}
+
+		static size_t SDLCALL write_fn(SDL_RWops *, const void *, size_t, size_t) {
+			SDL_SetError("archive: entries are read-only");
+			return 0;
+		}
+
+		static int SDLCALL close_fn(SDL_RWops *rw) {
+			if (rw != nullptr) {
+				delete from(rw);
+				SDL_FreeRW(rw);
+			}
+			return 0;
+		}
+	};
+
+	static std::map<compression, codec> &codecs() {
+		static std::map<compression, codec> list;
+		return list;
+	}
+
+	static file null_file() { return file(file::handle_holder(nullptr, file::handle_closer)); }
+
+	bool read_at(size_type offset, void *dst, std::size_t size) const {
+		if (_memory != nullptr) {
+			if ((offset > _memory_size) || (size > _memory_size - offset)) return false;
+			std::memcpy(dst, _memory + offset, size);
+			return true;
+		}
+		if (SDL_RWseek(_file.get(), static_cast<Sint64>(offset), RW_SEEK_SET) < 0) return false;
+		return (SDL_RWread(_file.get(), dst, 1, size) == size);
+	}
+
+	Sint64 archive_size() const noexcept {
+		return (_memory != nullptr) ? static_cast<Sint64>(_memory_size) : SDL_RWsize(_file.get());
+	}
+
+	bool read_index() {
+		auto total = archive_size();
+		if (total < 0) return false;
+		auto archive_bytes = static_cast<size_type>(total);
+
+		Uint8 header[header_size];
+		if (!read_at(0, header, sizeof(header))) return false;
+
+		if ((load_le<Uint32>(header) != magic) || (load_le<Uint32>(header + 4) != format_version)) {
+			SDL_SetError("archive: bad header");
+			return false;
+		}
+
+		auto count = load_le<Uint32>(header + 8);
+		auto alignment = load_le<Uint32>(header + 12);
+		auto index_offset = load_le<Uint64>(header + 16);
+		auto index_size = load_le<Uint64>(header + 24);
+
+		if ((index_offset > archive_bytes) || (index_size > archive_bytes - index_offset) || (count > index_size / entry_header_size)) {
+			SDL_SetError("archive: bad index");
+			return false;
+		}
+
+		std::vector<Uint8> index(static_cast<std::size_t>(index_size));
+		if (!read_at(index_offset, index.data(), index.size())) return false;
+
+		std::vector<entry> list;
+		list.reserve(count);
+
+		const Uint8 *p = index.data();
+		const Uint8 *end = p + index.size();
+		for (Uint32 i = 0; i < count; ++i) {
+			if (static_cast<std::size_t>(end - p) < entry_header_size) return false;
+
+			entry e;
+			e.hash = load_le<Uint64>(p);
+			e.offset = load_le<Uint64>(p + 8);
+			e.size = load_le<Uint64>(p + 16);
+			e.stored_size = load_le<Uint64>(p + 24);
+			e.method = static_cast<compression>(load_le<Uint32>(p + 32));
+			auto name_length = load_le<Uint32>(p + 36);
+			p += entry_header_size;
+
+			if (static_cast<std::size_t>(end - p) < name_length) return false;
+			e.name.assign(reinterpret_cast<const char *>(p), name_length);
+			p += name_length;
+
+			if ((e.offset > archive_bytes) || (e.stored_size > archive_bytes - e.offset)
+				|| ((e.method == compression::none) && (e.size != e.stored_size))) {
+				SDL_SetError("archive: bad entry '%s'", e.name.c_str());
+				return false;
+			}
+
+			list.emplace_back(std::move(e));
+		}
+
+		std::stable_sort(list.begin(), list.end(), [](const entry &a, const entry &b) { return a.hash < b.hash; });
+
+		_entries = std::move(list);
+		_alignment = (alignment != 0) ? alignment : 1;
+		return true;
+	}
+
+private:
+	file _file { file::handle_holder(nullptr, file::handle_closer) };
+	const Uint8 *_memory = nullptr;
+	std::size_t _memory_size = 0;
+	std::vector<entry> _entries;
+	Uint32 _alignment = 0;
+};
+
+class archive_writer final {
+public:
+	explicit archive_writer(Uint32 alignment = archive::default_alignment) : _alignment((alignment != 0) ? alignment : 1) {}
+
+	Uint32 alignment() const noexcept { return _alignment; }
+
+	std::size_t size() const noexcept { return _items.size(); }
+
+	void clear() noexcept { _items.clear(); }
+
+	bool add(const std::string &name, const void *data, std::size_t size, archive::compression method = archive::compression::none) {
+		item i;
+		i.name = name;
+		i.size = size;
+		i.method = archive::compression::none;
+
+		if (method != archive::compression::none) {
+			auto c = archive::find_codec(method);
+			if ((c != nullptr) && c->encode && c->encode(data, size, i.data) && (i.data.size() < size)) {
+				i.method = method;
+			}
+		}
+
+		if (i.method == archive::compression::none) {
+			auto p = static_cast<const Uint8 *>(data);
+			i.data.assign(p, p + size);
+		}
+
+		auto it = std::find_if(_items.begin(), _items.end(), [&name](const item &rhs) { return rhs.name == name; });
+		if (it != _items.end()) {
+			*it = std::move(i);
+		} else {
+			_items.emplace_back(std::move(i));
+		}
+		return true;
+	}
+
+	bool add_file(const std::string &name, const char *path, archive::compression method = archive::compression::none) {
+		file src(path, "rb");
+		if (!src) return false;
+
+		auto size = src.size();
+		if (size < 0) return false;
+
+		std::vector<Uint8> buffer(static_cast<std::size_t>(size));
+		if (!buffer.empty() && (src.read(buffer.data(), 1, buffer.size()) != buffer.size())) return false;
+
+		return add(name, buffer.data(), buffer.size(), method);
+	}
+
+	bool save(const char *path) const {
+		file dst(path, "wb");
+		return dst && save(dst.get());
+	}
+
+	bool save(SDL_RWops *dst) const {
+		std::vector<const item *> order;
+		for (auto &i : _items) order.push_back(&i);
+		std::stable_sort(order.begin(), order.end(), [](const item *a, const item *b) {
+			return archive::hash(a->name) < archive::hash(b->name);
+		});
+
+		std::vector<Uint8> index;
+		std::vector<Uint64> offsets;
+		Uint64 offset = align(archive::header_size);
+		for (auto i : order) {
+			offsets.push_back(offset);
+			offset = align(offset + i->data.size());
+		}
+
+		for (std::size_t n = 0; n < order.size(); ++n) {
+			auto i = order[n];
+			archive::store_le<Uint64>(index, archive::hash(i->name));
+			archive::store_le<Uint64>(index, offsets[n]);
+			archive::store_le<Uint64>(index, i->size);
+			archive::store_le<Uint64>(index, i->data.size());
+			archive::store_le<Uint32>(index, static_cast<Uint32>(i->method));
+			archive::store_le<Uint32>(index, static_cast<Uint32>(i->name.size()));
+			index.insert(index.end(), i->name.begin(), i->name.end());
+		}
+
+		std::vector<Uint8> header;
+		archive::store_le<Uint32>(header, archive::magic);
+		archive::store_le<Uint32>(header, archive::format_version);
+		archive::store_le<Uint32>(header, static_cast<Uint32>(order.size()));
+		archive::store_le<Uint32>(header, _alignment);
+		archive::store_le<Uint64>(header, offset);
+		archive::store_le<Uint64>(header, index.size());
+
+		Uint64 position = 0;
+		auto write = [dst, &position](const void *p, std::size_t size) {
+			if ((size != 0) && (SDL_RWwrite(dst, p, 1, size) != size)) return false;
+			position += size;
+			return true;
+		};
+		auto pad = [&write, &position](Uint64 target) {
+			static const Uint8 zero[64] = {};
+			while (position < target) {
+				if (!write(zero, static_cast<std::size_t>(std::min<Uint64>(sizeof(zero), target - position)))) return false;
+			}
+			return true;
+		};
+
+		if (!write(header.data(), header.size())) return false;
+		for (std::size_t n = 0; n < order.size(); ++n) {
+			if (!pad(offsets[n]) || !write(order[n]->data.data(), order[n]->data.size())) return false;
+		}
+		return pad(offset) && write(index.data(), index.size());
+	}
+
+private:
+	struct item {
+		std::string name;
+		Uint64 size;
+		archive::compression method;
+		std::vector<Uint8> data;
+	};
+
+	Uint64 align(Uint64 value) const noexcept { return ((value + _alignment - 1) / _alignment) * _alignment; }
+
+	Uint32 _alignment;
+	std::vector<item> _items;
+};
+
+} } // namespace sdl::io
+
+#endif // SDL2_WRAPPER_IO_ARCHIVE_HPP_
@@ -0,0 +1,369 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_IO_ASSET_LOADER_HPP_
+#define SDL2_WRAPPER_IO_ASSET_LOADER_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sdl { inline namespace io {
+
+class asset_loader final {
+public:
+	using job_id = std::size_t;
+	using job_function = std::function<bool ()>;
+
+	static constexpr job_id invalid_job = std::numeric_limits<job_id>::max();
+
+	enum class job_type : int {
+		decode,
+		upload,
+	};
+
+	enum class job_state : int {
+		waiting,
+		queued,
+		running,
+		completed,
+		failed,
+	};
+
+	struct progress_info {
+		std::size_t total = 0;
+		std::size_t completed = 0;
+		std::size_t failed = 0;
+
+		std::size_t finished() const noexcept { return completed + failed; }
+
+		float ratio() const noexcept { return (total != 0) ? static_cast<float>(finished()) / static_cast<float>(total) : 1.0f; }
+	};
+
+	template <typename T>
+	class asset final {
+	public:
+		asset() = default;
+
+		job_id id() const noexcept { return _id; }
+
+		std::shared_ptr<T> get() const { return _holder ? _holder->value : nullptr; }
+
+		explicit operator bool() const noexcept { return (_id != invalid_job); }
+
+	private:
+		friend class asset_loader;
+
+		struct holder {
+			std::shared_ptr<T> value;
+		};
+
+		job_id _id = invalid_job;
+		std::shared_ptr<holder> _holder = std::make_shared<holder>();
+	};
+
+public:
+	explicit asset_loader(unsigned int workers = 0) {
+		if (workers == 0) {
+			workers = static_cast<unsigned int>(std::max(1, sdl::cpu::cores() - 1));
+		}
+		for (unsigned int i = 0; i < workers; ++i) {
+			_workers.emplace_back([this] { work(); });
+		}
+	}
+
+	explicit asset_loader(task_system &tasks) : _tasks(&tasks) {}
+
+	asset_loader(const asset_loader &) = delete;
+
+	asset_loader &operator =(const asset_loader &) = delete;
+
+	~asset_loader() {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_stopping = true;
+			_main_signal.wait(lock, [this] { return (_in_flight == 0); });
+		}
+		_worker_signal.notify_all();
+		for (auto &t : _workers) t.join();
+	}
+
+	job_id add(job_type type, job_function fn, const std::vector<job_id> &dependencies = {}) {
+		std::vector<job_id> submissions;
+		job_id id;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			id = _base + _jobs.size();
+			_jobs.emplace_back();
+
+			auto &j = _jobs.back();
+			j.type = type;
+			j.function = std::move(fn);
+			++_progress.total;
+
+			for (auto dep : dependencies) {
+				if ((dep < _base) || (dep >= id)) continue;
+
+				auto &d = at(dep);
+				if (d.state == job_state::failed) {
+					j.dependency_failed = true;
+
+				} else if (d.state != job_state::completed) {
+					d.dependents.push_back(id);
+					++j.pending;
+				}
+			}
+
+			if (j.pending == 0) ready(id, submissions);
+		}
+		submit(submissions);
+		return id;
+	}
+
+	job_id decode(job_function fn, std::initializer_list<job_id> dependencies = {}) {
+		return add(job_type::decode, std::move(fn), dependencies);
+	}
+
+	job_id upload(job_function fn, std::initializer_list<job_id> dependencies = {}) {
+		return add(job_type::upload, std::move(fn), dependencies);
+	}
+
+	asset<surface> load_surface(const std::string &path) {
+		asset<surface> result;
+		auto holder = result._holder;
+		result._id = decode([holder, path] {
+			auto s = std::make_shared<surface>(path.c_str());
+			if (!s->valid()) return false;
+			holder->value = std::move(s);
+			return true;
+		});
+		return result;
+	}
+
+	asset<sound> load_sound(const std::string &path) {
+		asset<sound> result;
+		auto holder = result._holder;
+		result._id = decode([holder, path] {
+			auto s = std::make_shared<sound>();
+			if (!s->load(path)) return false;
+			holder->value = std::move(s);
+			return true;
+		});
+		return result;
+	}
+
+	asset<texture> create_texture(SDL_Renderer *renderer, const asset<surface> &source) {
+		asset<texture> result;
+		auto holder = result._holder;
+		auto source_holder = source._holder;
+		result._id = upload([holder, source_holder, renderer] {
+			auto s = source_holder->value;
+			if (!s) return false;
+			auto t = std::make_shared<texture>(renderer, s->get());
+			if (!t->valid()) return false;
+			holder->value = std::move(t);
+			return true;
+		}, { source.id() });
+		return result;
+	}
+
+	std::size_t pump(std::size_t max_jobs = std::numeric_limits<std::size_t>::max()) {
+		std::vector<job_id> batch;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			while (!_main_queue.empty() && (batch.size() < max_jobs)) {
+				batch.push_back(_main_queue.front());
+				_main_queue.pop_front();
+				at(batch.back()).state = job_state::running;
+			}
+		}
+
+		for (auto id : batch) run(id);
+		return batch.size();
+	}
+
+	void wait() {
+		while (true) {
+			pump();
+
+			std::unique_lock<std::mutex> lock(_mutex);
+			_main_signal.wait(lock, [this] { return !_main_queue.empty() || finished(); });
+			if (_main_queue.empty() && finished()) break;
+		}
+	}
+
+	bool done() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return finished();
+	}
+
+	job_state state(job_id id) const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return ((id >= _base) && (id - _base < _jobs.size())) ? at(id).state : job_state::failed;
+	}
+
+	progress_info progress() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _progress;
+	}
+
+	bool clear() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!finished()) return false;
+		_base += _jobs.size();
+		_jobs.clear();
+		_progress = progress_info();
+		return true;
+	}
+
+private:
+	struct job {
+		job_type type = job_type::decode;
+		job_state state = job_state::waiting;
+		job_function function;
+		std::vector<job_id> dependents;
+		std::size_t pending = 0;
+		bool dependency_failed = false;
+	};
+
+	// Ids keep growing across clear() so handles from before it never alias
+	// new jobs; _base is the id of _jobs.front().
+	job &at(job_id id) noexcept { return _jobs[id - _base]; }
+
+	const job &at(job_id id) const noexcept { return _jobs[id - _base]; }
+
+	bool finished() const noexcept { return (_progress.finished() == _progress.total); }
+
+	// Called with _mutex held. Decode jobs bound for the task system are
+	// collected in submissions and handed over by submit() once the caller
+	// has released the lock, so task_system::run() never runs under _mutex.
+	void ready(job_id id, std::vector<job_id> &submissions) {
+		auto &j = at(id);
+		if (j.dependency_failed) {
+			finish(id, false, submissions);
+			return;
+		}
+
+		j.state = job_state::queued;
+		if ((j.type == job_type::decode) && (_tasks != nullptr)) {
+			++_in_flight;
+			submissions.push_back(id);
+		} else if (j.type == job_type::decode) {
+			_worker_queue.push_back(id);
+			_worker_signal.notify_one();
+		} else {
+			_main_queue.push_back(id);
+			_main_signal.notify_all();
+		}
+	}
+
+	void submit(const std::vector<job_id> &submissions) {
+		for (auto id : submissions) {
+			_tasks->run([this, id] {
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					at(id).state = job_state::running;
+				}
+				run(id);
+
+				std::lock_guard<std::mutex> lock(_mutex);
+				--_in_flight;
+				_main_signal.notify_all();
+			});
+		}
+	}
+
+	void finish(job_id id, bool succeeded, std::vector<job_id> &submissions) {
+		auto &j = at(id);
+		j.state = succeeded ? job_state::completed : job_state::failed;
+		j.function = nullptr;
+		++(succeeded ? _progress.completed : _progress.failed);
+
+		auto dependents = std::move(j.dependents);
+		for (auto dep : dependents) {
+			auto &d = at(dep);
+			if (!succeeded) d.dependency_failed = true;
+			if (--d.pending == 0) ready(dep, submissions);
+		}
+
+		_main_signal.notify_all();
+	}
+
+	void run(job_id id) {
+		job_function fn;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			fn = std::move(at(id).function);
+		}
+
+		bool succeeded = fn ? fn() : true;
+
+		std::vector<job_id> submissions;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			finish(id, succeeded, submissions);
+		}
+		submit(submissions);
+	}
+
+	void work() {
+		while (true) {
+			job_id id;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_worker_signal.wait(lock, [this] { return _stopping || !_worker_queue.empty(); });
+				if (_worker_queue.empty()) return;
+
+				id = _worker_queue.front();
+				_worker_queue.pop_front();
+				at(id).state = job_state::running;
+			}
+			run(id);
+		}
+	}
+
+private:
+	mutable std::mutex _mutex;
+	std::condition_variable _worker_signal;
+	std::condition_variable _main_signal;
+	std::deque<job> _jobs;
+	job_id _base = 0;
+	std::deque<job_id> _worker_queue;
+	std::deque<job_id> _main_queue;
+	progress_info _progress;
+	std::vector<std::thread> _workers;
+	task_system *_tasks = nullptr;
+	std::size_t _in_flight = 0;
+	bool _stopping = false;
+};
+
+} } // namespace sdl::io
+
+#endif // SDL2_WRAPPER_IO_ASSET_LOADER_HPP_
@@ -0,0 +1,243 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_IO_RESOURCE_CACHE_HPP_
+#define SDL2_WRAPPER_IO_RESOURCE_CACHE_HPP_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace sdl { inline namespace io {
+
+inline std::size_t resource_size(const surface &s) noexcept {
+	if (!s.valid()) return 0;
+
+	std::size_t result = sizeof(SDL_Surface) + static_cast<std::size_t>(s.pitch()) * static_cast<std::size_t>(s.h());
+	auto format = s.format();
+	if ((format != nullptr) && (format->palette != nullptr)) {
+		result += sizeof(SDL_Palette) + sizeof(SDL_Color) * static_cast<std::size_t>(format->palette->ncolors);
+	}
+	return result;
+}
+
+inline std::size_t resource_size(const texture &t) noexcept { return texture_size(t.get()); }
+
+inline std::size_t resource_size(const sound &s) noexcept { return sizeof(sound) + s.length(); }
+
+template <typename Key, typename Resource, typename Hash = std::hash<Key>>
+class resource_cache final {
+public:
+	using key_type = Key;
+	using resource_type = Resource;
+	using pointer = std::shared_ptr<resource_type>;
+	using loader = std::function<pointer (const key_type &)>;
+
+	struct statistics {
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+		std::size_t evictions = 0;
+		std::size_t failures = 0;
+		std::size_t count = 0;
+		std::size_t bytes = 0;
+		std::size_t peak_bytes = 0;
+	};
+
+public:
+	explicit resource_cache(std::size_t budget, loader load = nullptr) : _budget(budget), _loader(std::move(load)) {}
+
+	resource_cache(const resource_cache &) = delete;
+
+	resource_cache &operator =(const resource_cache &) = delete;
+
+	pointer get(const key_type &key) { return _loader ? get(key, _loader) : find(key); }
+
+	template <typename Load>
+	pointer get(const key_type &key, Load &&load) {
+		if (auto result = find(key)) return result;
+
+		pointer result = wrap(load(key));
+		if (!result || !usable(*result, 0)) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			++_stats.failures;
+			return nullptr;
+		}
+
+		return insert(key, std::move(result));
+	}
+
+	pointer find(const key_type &key) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto it = _entries.find(key);
+		if (it == _entries.end()) {
+			++_stats.misses;
+			return nullptr;
+		}
+
+		++_stats.hits;
+		_lru.splice(_lru.begin(), _lru, it->second.lru);
+		return it->second.resource;
+	}
+
+	pointer insert(const key_type &key, pointer resource) {
+		if (!resource || !usable(*resource, 0)) return nullptr;
+
+		auto size = resource_size(*resource);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto it = _entries.find(key);
+		if (it != _entries.end()) {
+			_lru.splice(_lru.begin(), _lru, it->second.lru);
+			return it->second.resource;
+		}
+
+		_lru.push_front(key);
+		_entries.emplace(key, entry { std::move(resource), size, _lru.begin() });
+		_stats.count = _entries.size();
+		_stats.bytes += size;
+		if (_stats.bytes > _stats.peak_bytes) _stats.peak_bytes = _stats.bytes;
+
+		auto result = _entries.find(key)->second.resource;
+		trim();
+		return result;
+	}
+
+	bool erase(const key_type &key) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto it = _entries.find(key);
+		if (it == _entries.end()) return false;
+
+		remove(it);
+		return true;
+	}
+
+	void clear() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_entries.clear();
+		_lru.clear();
+		_stats.count = 0;
+		_stats.bytes = 0;
+	}
+
+	bool contains(const key_type &key) const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return (_entries.find(key) != _entries.end());
+	}
+
+	void budget(std::size_t bytes) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_budget = bytes;
+		trim();
+	}
+
+	std::size_t budget() const noexcept { return _budget; }
+
+	std::size_t bytes() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _stats.bytes;
+	}
+
+	std::size_t size() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _entries.size();
+	}
+
+	statistics stats() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _stats;
+	}
+
+	void reset_stats() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stats.hits = _stats.misses = _stats.evictions = _stats.failures = 0;
+		_stats.peak_bytes = _stats.bytes;
+	}
+
+private:
+	struct entry {
+		pointer resource;
+		std::size_t size;
+		typename std::list<key_type>::iterator lru;
+	};
+
+	using entry_map = std::unordered_map<key_type, entry, Hash>;
+
+	// Resources exposing valid() are checked so a failed load is not cached.
+	template <typename T>
+	static auto usable(const T &r, int) noexcept -> decltype(bool(r.valid())) { return r.valid(); }
+
+	template <typename T>
+	static bool usable(const T &, long) noexcept { return true; }
+
+	static pointer wrap(pointer p) noexcept { return p; }
+
+	template <typename T, std::enable_if_t<std::is_same<std::decay_t<T>, resource_type>::value, std::nullptr_t> = nullptr>
+	static pointer wrap(T &&r) { return std::make_shared<resource_type>(std::move(r)); }
+
+	void remove(typename entry_map::iterator it) {
+		_stats.bytes -= it->second.size;
+		_lru.erase(it->second.lru);
+		_entries.erase(it);
+		_stats.count = _entries.size();
+	}
+
+	void trim() {
+		while ((_stats.bytes > _budget) && !_lru.empty()) {
+			remove(_entries.find(_lru.back()));
+			++_stats.evictions;
+		}
+	}
+
+private:
+	mutable std::mutex _mutex;
+	std::size_t _budget;
+	loader _loader;
+	entry_map _entries;
+	std::list<key_type> _lru;
+	statistics _stats;
+};
+
+using surface_cache = resource_cache<std::string, surface>;
+
+using texture_cache = resource_cache<std::string, texture>;
+
+using sound_cache = resource_cache<std::string, sound>;
+
+inline surface_cache::pointer load_surface(const std::string &path) {
+	auto result = std::make_shared<surface>(path.c_str());
+	return result->valid() ? result : nullptr;
+}
+
+inline sound_cache::pointer load_sound(const std::string &path) {
+	auto result = std::make_shared<sound>();
+	return (result->load(path) && result->valid()) ? result : nullptr;
+}
+
+} } // namespace sdl::io
+
+#endif // SDL2_WRAPPER_IO_RESOURCE_CACHE_HPP_
@@ -34,5 +34,11 @@
 // SDL_loadso.h
 #include "system/object.hpp"
 
+// task scheduling
+#include "system/task_system.hpp"
+
+// resource handles
+#include "system/handle_table.hpp"
+
 #endif // SDL2_WRAPPER_SYSTEM_HPP_
 
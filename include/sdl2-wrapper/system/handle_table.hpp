@@ -0,0 +1,275 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_SYSTEM_HANDLE_TABLE_HPP_
+#define SDL2_WRAPPER_SYSTEM_HANDLE_TABLE_HPP_
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sdl { inline namespace system {
+
+template <typename T, unsigned int IndexBits = 20>
+class handle_table final {
+	static_assert((IndexBits > 0) && (IndexBits < 32), "index bits must leave room for a generation");
+
+public:
+	using value_type = T;
+	using iterator = typename std::vector<T>::iterator;
+	using const_iterator = typename std::vector<T>::const_iterator;
+
+	class handle final {
+	public:
+		constexpr handle() noexcept = default;
+
+		constexpr explicit handle(Uint32 value) noexcept : _value(value) {}
+
+		constexpr Uint32 value() const noexcept { return _value; }
+
+		constexpr Uint32 index() const noexcept { return (_value & index_mask); }
+
+		constexpr Uint32 generation() const noexcept { return (_value >> IndexBits); }
+
+		constexpr explicit operator bool() const noexcept { return (_value != 0); }
+
+		constexpr bool operator ==(const handle &rhs) const noexcept { return (_value == rhs._value); }
+
+		constexpr bool operator !=(const handle &rhs) const noexcept { return (_value != rhs._value); }
+
+	private:
+		friend class handle_table;
+
+		static constexpr handle make(Uint32 index, Uint32 generation) noexcept {
+			return handle((generation << IndexBits) | index);
+		}
+
+		Uint32 _value = 0;
+	};
+
+	static constexpr Uint32 index_mask = (Uint32(1) << IndexBits) - 1;
+	static constexpr Uint32 generation_mask = ~Uint32(0) >> IndexBits;
+	static constexpr std::size_t max_size = index_mask;
+
+public:
+	handle_table() = default;
+
+	explicit handle_table(std::size_t capacity) { reserve(capacity); }
+
+	handle_table(const handle_table &) = delete;
+
+	handle_table &operator =(const handle_table &) = delete;
+
+	handle_table(handle_table &&rhs) noexcept
+		: _objects(std::move(rhs._objects)), _owners(std::move(rhs._owners)), _slots(std::move(rhs._slots)), _free(rhs._free) {
+		rhs.abandon();
+	}
+
+	handle_table &operator =(handle_table &&rhs) noexcept {
+		if (this != &rhs) {
+			_objects = std::move(rhs._objects);
+			_owners = std::move(rhs._owners);
+			_slots = std::move(rhs._slots);
+			_free = rhs._free;
+			rhs.abandon();
+		}
+		return *this;
+	}
+
+	void reserve(std::size_t capacity) {
+		_objects.reserve(capacity);
+		_owners.reserve(capacity);
+		_slots.reserve(capacity);
+	}
+
+	handle insert(T &&object) { return emplace(std::move(object)); }
+
+	template <typename ...Args>
+	handle emplace(Args &&...args) {
+		auto index = acquire_slot();
+		if (index == invalid_slot) return handle();
+
+		try {
+			_owners.push_back(index);
+			_objects.emplace_back(std::forward<Args>(args)...);
+		} catch (...) {
+			if (_owners.size() > _objects.size()) _owners.pop_back();
+			release_slot(index);
+			throw;
+		}
+
+		auto &s = _slots[index];
+		s.dense = static_cast<Uint32>(_objects.size() - 1);
+		return handle::make(index, s.generation);
+	}
+
+	bool erase(handle h) {
+		auto s = live_slot(h);
+		if (s == nullptr) return false;
+
+		auto dense = s->dense;
+		auto last = static_cast<Uint32>(_objects.size() - 1);
+		if (dense != last) {
+			_objects[dense] = std::move(_objects[last]);
+			_owners[dense] = _owners[last];
+			_slots[_owners[dense]].dense = dense;
+		}
+		_objects.pop_back();
+		_owners.pop_back();
+
+		release_slot(h.index());
+		return true;
+	}
+
+	void clear() noexcept {
+		for (auto index : _owners) release_slot(index);
+		_objects.clear();
+		_owners.clear();
+	}
+
+	bool contains(handle h) const noexcept { return (live_slot(h) != nullptr); }
+
+	T *find(handle h) noexcept {
+		auto s = live_slot(h);
+		return (s != nullptr) ? &_objects[s->dense] : nullptr;
+	}
+
+	const T *find(handle h) const noexcept {
+		auto s = live_slot(h);
+		return (s != nullptr) ? &_objects[s->dense] : nullptr;
+	}
+
+	T &operator [](handle h) noexcept {
+		assert(contains(h));
+		return _objects[_slots[h.index()].dense];
+	}
+
+	const T &operator [](handle h) const noexcept {
+		assert(contains(h));
+		return _objects[_slots[h.index()].dense];
+	}
+
+	handle handle_at(std::size_t position) const noexcept {
+		auto index = _owners[position];
+		return handle::make(index, _slots[index].generation);
+	}
+
+	std::size_t size() const noexcept { return _objects.size(); }
+
+	bool empty() const noexcept { return _objects.empty(); }
+
+	std::size_t capacity() const noexcept { return _slots.size(); }
+
+	T *data() noexcept { return _objects.data(); }
+
+	const T *data() const noexcept { return _objects.data(); }
+
+	iterator begin() noexcept { return _objects.begin(); }
+
+	iterator end() noexcept { return _objects.end(); }
+
+	const_iterator begin() const noexcept { return _objects.begin(); }
+
+	const_iterator end() const noexcept { return _objects.end(); }
+
+	const_iterator cbegin() const noexcept { return _objects.cbegin(); }
+
+	const_iterator cend() const noexcept { return _objects.cend(); }
+
+	template <typename Function>
+	void each(Function &&fn) {
+		for (std::size_t i = 0; i < _objects.size(); ++i) fn(handle_at(i), _objects[i]);
+	}
+
+private:
+	static constexpr Uint32 invalid_slot = ~Uint32(0);
+	static constexpr Uint32 free_bit = Uint32(1) << 31;
+
+	// Slots live in a separate sparse array so the dense object array stays
+	// contiguous; a free slot reuses "dense" as the next link of the free list.
+	struct slot {
+		Uint32 dense;
+		Uint32 generation;
+	};
+
+	const slot *live_slot(handle h) const noexcept {
+		auto index = h.index();
+		if (index >= _slots.size()) return nullptr;
+
+		auto &s = _slots[index];
+		return ((s.generation == h.generation()) && ((s.dense & free_bit) == 0)) ? &s : nullptr;
+	}
+
+	slot *live_slot(handle h) noexcept {
+		return const_cast<slot *>(static_cast<const handle_table *>(this)->live_slot(h));
+	}
+
+	Uint32 acquire_slot() {
+		if (_free != invalid_slot) {
+			auto index = _free;
+			auto next = _slots[index].dense & ~free_bit;
+			_free = (next == index_mask) ? invalid_slot : next;
+			return index;
+		}
+
+		if (_slots.size() >= max_size) {
+			SDL_SetError("handle table is full");
+			return invalid_slot;
+		}
+
+		_slots.push_back(slot { free_bit, 1 });
+		return static_cast<Uint32>(_slots.size() - 1);
+	}
+
+	// Leaves a moved-from table empty, with no free list pointing into the
+	// slots it gave away.
+	void abandon() noexcept {
+		_objects.clear();
+		_owners.clear();
+		_slots.clear();
+		_free = invalid_slot;
+	}
+
+	void release_slot(Uint32 index) noexcept {
+		auto &s = _slots[index];
+		s.generation = (s.generation + 1) & generation_mask;
+		s.dense = free_bit | index_mask;
+
+		// Generation 0 is never handed out, so the null handle stays invalid;
+		// a slot whose counter wraps is retired rather than risking a stale
+		// handle aliasing a new object.
+		if (s.generation == 0) return;
+
+		if (_free != invalid_slot) s.dense = free_bit | _free;
+		_free = index;
+	}
+
+private:
+	std::vector<T> _objects;
+	std::vector<Uint32> _owners;
+	std::vector<slot> _slots;
+	Uint32 _free = invalid_slot;
+};
+
+} } // namespace sdl::system
+
+#endif // SDL2_WRAPPER_SYSTEM_HANDLE_TABLE_HPP_
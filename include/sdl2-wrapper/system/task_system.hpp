@@ -0,0 +1,275 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_SYSTEM_TASK_SYSTEM_HPP_
+#define SDL2_WRAPPER_SYSTEM_TASK_SYSTEM_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sdl { inline namespace system {
+
+class task_system final {
+public:
+	using task = std::function<void ()>;
+
+	class group final {
+	public:
+		group() : _state(std::make_shared<state>()) {}
+
+		std::size_t pending() const noexcept { return _state->pending.load(std::memory_order_acquire); }
+
+		bool done() const noexcept { return (pending() == 0); }
+
+	private:
+		friend class task_system;
+
+		struct state {
+			std::atomic<std::size_t> pending { 0 };
+			std::mutex mutex;
+			std::vector<task> continuations;
+		};
+
+		std::shared_ptr<state> _state;
+	};
+
+public:
+	explicit task_system(unsigned int threads = 0) {
+		if (threads == 0) {
+			threads = static_cast<unsigned int>(std::max(1, sdl::cpu::cores() - 1));
+		}
+
+		for (unsigned int i = 0; i <= threads; ++i) {
+			_queues.emplace_back(std::make_unique<queue>());
+		}
+		for (unsigned int i = 0; i < threads; ++i) {
+			_threads.emplace_back([this, i] { work(i); });
+		}
+	}
+
+	task_system(const task_system &) = delete;
+
+	task_system &operator =(const task_system &) = delete;
+
+	~task_system() {
+		{
+			std::lock_guard<std::mutex> lock(_sleep_mutex);
+			_stopping = true;
+		}
+		_sleep_signal.notify_all();
+		for (auto &t : _threads) t.join();
+	}
+
+	unsigned int size() const noexcept { return static_cast<unsigned int>(_threads.size()); }
+
+	void run(task fn) { push(item { std::move(fn), nullptr }); }
+
+	void run(group &g, task fn) {
+		g._state->pending.fetch_add(1, std::memory_order_relaxed);
+		push(item { std::move(fn), g._state });
+	}
+
+	void then(group &g, task fn) {
+		auto &s = *g._state;
+		{
+			std::lock_guard<std::mutex> lock(s.mutex);
+			if (s.pending.load(std::memory_order_acquire) != 0) {
+				s.continuations.emplace_back(std::move(fn));
+				return;
+			}
+		}
+		run(std::move(fn));
+	}
+
+	void wait(group &g) {
+		while (!g.done()) {
+			if (!execute_one()) std::this_thread::yield();
+		}
+	}
+
+	template <typename Index, typename Function>
+	void parallel_for(Index begin, Index end, Index grain, Function &&fn) {
+		if (begin >= end) return;
+
+		group g;
+		split(g, begin, end, std::max<Index>(grain, 1), fn);
+		wait(g);
+	}
+
+	template <typename Index, typename Function>
+	void parallel_for(Index begin, Index end, Function &&fn) {
+		auto chunks = static_cast<Index>((size() + 1) * 4);
+		parallel_for(begin, end, static_cast<Index>((end - begin + chunks - 1) / chunks), std::forward<Function>(fn));
+	}
+
+private:
+	struct item {
+		task function;
+		std::shared_ptr<group::state> owner;
+	};
+
+	struct queue {
+		char head_padding[cpu::safe_cache_line_size];
+		std::mutex mutex;
+		std::deque<item> items;
+		char tail_padding[cpu::safe_cache_line_size];
+	};
+
+	struct worker_context {
+		const task_system *owner;
+		std::size_t index;
+	};
+
+	static worker_context &context() noexcept {
+		static thread_local worker_context current { nullptr, 0 };
+		return current;
+	}
+
+	std::size_t local_index() const noexcept {
+		auto &c = context();
+		return (c.owner == this) ? c.index : _threads.size();
+	}
+
+	template <typename Index, typename Function>
+	void split(group &g, Index begin, Index end, Index grain, Function &fn) {
+		while (end - begin > grain) {
+			Index middle = begin + (end - begin) / 2;
+			run(g, [this, &g, &fn, middle, end, grain] { split(g, middle, end, grain, fn); });
+			end = middle;
+		}
+		fn(begin, end);
+	}
+
+	void push(item &&i) {
+		auto &q = *_queues[local_index()];
+		{
+			std::lock_guard<std::mutex> lock(q.mutex);
+			q.items.emplace_back(std::move(i));
+		}
+		_queued.fetch_add(1);
+
+		if (_sleeping.load() != 0) {
+			std::lock_guard<std::mutex> lock(_sleep_mutex);
+			_sleep_signal.notify_one();
+		}
+	}
+
+	bool pop(std::size_t index, item &out) {
+		auto &q = *_queues[index];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if (q.items.empty()) return false;
+
+		out = std::move(q.items.back());
+		q.items.pop_back();
+		return true;
+	}
+
+	bool steal(std::size_t index, item &out) {
+		auto &q = *_queues[index];
+		std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+		if (!lock || q.items.empty()) return false;
+
+		out = std::move(q.items.front());
+		q.items.pop_front();
+		return true;
+	}
+
+	bool acquire(item &out) {
+		if (_queued.load() == 0) return false;
+
+		auto self = local_index();
+		bool found = pop(self, out);
+		for (std::size_t n = 1; !found && (n < _queues.size()); ++n) {
+			found = steal((self + n) % _queues.size(), out);
+		}
+		if (found) _queued.fetch_sub(1);
+		return found;
+	}
+
+	bool execute_one() {
+		item i;
+		if (!acquire(i)) return false;
+
+		i.function();
+
+		if (i.owner && (i.owner->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)) {
+			std::vector<task> continuations;
+			{
+				std::lock_guard<std::mutex> lock(i.owner->mutex);
+				continuations.swap(i.owner->continuations);
+			}
+			for (auto &c : continuations) run(std::move(c));
+		}
+		return true;
+	}
+
+	void work(std::size_t index) {
+		context() = worker_context { this, index };
+
+		unsigned int misses = 0;
+		while (true) {
+			if (execute_one()) {
+				misses = 0;
+				continue;
+			}
+
+			// Work is queued but every steal lost its try_lock: back off
+			// rather than spinning on the queue mutexes.
+			if (_queued.load() != 0) {
+				if (++misses < 64) {
+					std::this_thread::yield();
+				} else {
+					std::this_thread::sleep_for(std::chrono::microseconds(50));
+				}
+				continue;
+			}
+			misses = 0;
+
+			std::unique_lock<std::mutex> lock(_sleep_mutex);
+			if (_stopping) break;
+
+			_sleeping.fetch_add(1);
+			_sleep_signal.wait(lock, [this] { return _stopping || (_queued.load() != 0); });
+			_sleeping.fetch_sub(1);
+		}
+	}
+
+private:
+	std::vector<std::unique_ptr<queue>> _queues;
+	std::vector<std::thread> _threads;
+	std::atomic<std::size_t> _queued { 0 };
+	std::atomic<int> _sleeping { 0 };
+	std::mutex _sleep_mutex;
+	std::condition_variable _sleep_signal;
+	bool _stopping = false;
+};
+
+} } // namespace sdl::system
+
+#endif // SDL2_WRAPPER_SYSTEM_TASK_SYSTEM_HPP_
@@ -24,6 +24,11 @@
 
 // SDL_timer.h
 #include "timer/timer.hpp"
+#include "timer/frame_clock.hpp"
+#include "timer/timer_wheel.hpp"
+
+// profiling
+#include "timer/profile.hpp"
 
 #endif // SDL2_WRAPPER_TIMER_HPP_
 
@@ -0,0 +1,169 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_TIMER_FRAME_CLOCK_HPP_
+#define SDL2_WRAPPER_TIMER_FRAME_CLOCK_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sdl { namespace timer {
+
+class frame_clock final {
+public:
+	struct statistics {
+		Uint64 frames = 0;
+		Uint64 paced = 0;
+		Uint64 resyncs = 0;
+		double last_ms = 0.0;
+		double mean_ms = 0.0;
+		double min_ms = std::numeric_limits<double>::max();
+		double max_ms = 0.0;
+		double m2 = 0.0;
+		double mean_error_ms = 0.0;
+		double max_error_ms = 0.0;
+
+		double variance_ms() const noexcept { return (frames > 1) ? m2 / static_cast<double>(frames - 1) : 0.0; }
+
+		double stddev_ms() const noexcept { return std::sqrt(variance_ms()); }
+	};
+
+public:
+	explicit frame_clock(double frame_rate = 60.0, double update_rate = 60.0)
+		: _frequency(peformance_frequency()) {
+		rates(frame_rate, update_rate);
+		reset();
+	}
+
+	void rates(double frame_rate, double update_rate) noexcept {
+		_frame_ticks = (frame_rate > 0.0) ? static_cast<double>(_frequency) / frame_rate : 0.0;
+		_update_ticks = static_cast<Uint64>(static_cast<double>(_frequency) / std::max(update_rate, 1.0));
+		_origin = peformance_counter();
+		_frame_index = 0;
+	}
+
+	void reset() noexcept {
+		_origin = _last = peformance_counter();
+		_frame_index = 0;
+		_accumulator = 0;
+		_stats = statistics();
+	}
+
+	void max_updates(unsigned int n) noexcept { _max_updates = std::max(n, 1u); }
+
+	unsigned int max_updates() const noexcept { return _max_updates; }
+
+	void spin_margin(Uint32 ms) noexcept { _spin_margin_ms = ms; }
+
+	Uint32 spin_margin() const noexcept { return _spin_margin_ms; }
+
+	unsigned int begin_frame() noexcept {
+		auto now = peformance_counter();
+		auto elapsed = now - _last;
+		_last = now;
+
+		record(to_ms(elapsed));
+
+		_accumulator += elapsed;
+		auto updates = static_cast<unsigned int>(std::min<Uint64>(_accumulator / _update_ticks, _max_updates));
+		_accumulator -= static_cast<Uint64>(updates) * _update_ticks;
+		if (_accumulator >= _update_ticks) _accumulator %= _update_ticks;
+		return updates;
+	}
+
+	void end_frame() noexcept {
+		if (_frame_ticks <= 0.0) return;
+
+		++_frame_index;
+		auto target = deadline(_frame_index);
+		auto now = peformance_counter();
+
+		if ((now > target) && (static_cast<double>(now - target) > _frame_ticks)) {
+			_origin = now;
+			_frame_index = 0;
+			++_stats.resyncs;
+			return;
+		}
+
+		sleep_until(target);
+
+		auto error = to_ms(peformance_counter() - target);
+		++_stats.paced;
+		_stats.max_error_ms = std::max(_stats.max_error_ms, error);
+		_stats.mean_error_ms += (error - _stats.mean_error_ms) / static_cast<double>(_stats.paced);
+	}
+
+	void sleep_until(Uint64 target) const noexcept {
+		auto now = peformance_counter();
+		if (now >= target) return;
+
+		auto remaining_ms = to_ms(target - now);
+		if (remaining_ms > static_cast<double>(_spin_margin_ms)) {
+			delay(static_cast<Uint32>(remaining_ms) - _spin_margin_ms);
+		}
+
+		while (peformance_counter() < target) {}
+	}
+
+	double alpha() const noexcept { return static_cast<double>(_accumulator) / static_cast<double>(_update_ticks); }
+
+	double step() const noexcept { return static_cast<double>(_update_ticks) / static_cast<double>(_frequency); }
+
+	double frame_time() const noexcept { return _frame_ticks / static_cast<double>(_frequency); }
+
+	const statistics &stats() const noexcept { return _stats; }
+
+	void reset_stats() noexcept { _stats = statistics(); }
+
+private:
+	Uint64 deadline(Uint64 index) const noexcept { return _origin + static_cast<Uint64>(static_cast<double>(index) * _frame_ticks); }
+
+	double to_ms(Uint64 ticks) const noexcept { return static_cast<double>(ticks) * 1000.0 / static_cast<double>(_frequency); }
+
+	void record(double ms) noexcept {
+		auto &s = _stats;
+		++s.frames;
+		s.last_ms = ms;
+		s.min_ms = std::min(s.min_ms, ms);
+		s.max_ms = std::max(s.max_ms, ms);
+
+		auto delta = ms - s.mean_ms;
+		s.mean_ms += delta / static_cast<double>(s.frames);
+		s.m2 += delta * (ms - s.mean_ms);
+	}
+
+private:
+	Uint64 _frequency;
+	double _frame_ticks = 0.0;
+	Uint64 _update_ticks = 1;
+	Uint64 _origin = 0;
+	Uint64 _last = 0;
+	Uint64 _frame_index = 0;
+	Uint64 _accumulator = 0;
+	unsigned int _max_updates = 5;
+	Uint32 _spin_margin_ms = 2;
+	statistics _stats;
+};
+
+} } // namespace sdl::timer
+
+#endif // SDL2_WRAPPER_TIMER_FRAME_CLOCK_HPP_
@@ -0,0 +1,287 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_TIMER_PROFILE_HPP_
+#define SDL2_WRAPPER_TIMER_PROFILE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sdl { namespace timer {
+
+class profiler final {
+public:
+	static constexpr std::size_t ring_capacity = 4096;
+
+	struct record {
+		const char *name;
+		Uint64 begin;
+		Uint64 end;
+		Uint32 thread;
+	};
+
+	struct zone_stats {
+		const char *name;
+		std::size_t count;
+		double total_ms;
+		double min_ms;
+		double avg_ms;
+		double p99_ms;
+		double max_ms;
+	};
+
+	static profiler &instance() {
+		static profiler result;
+		return result;
+	}
+
+public:
+	profiler(const profiler &) = delete;
+
+	profiler &operator =(const profiler &) = delete;
+
+	void push(const char *name, Uint64 begin, Uint64 end) noexcept {
+		auto r = local_ring();
+		if (r == nullptr) return;
+
+		auto head = r->head.load(std::memory_order_relaxed);
+		if (head - r->tail.load(std::memory_order_acquire) >= ring_capacity) {
+			r->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		r->records[head & (ring_capacity - 1)] = record { name, begin, end, r->thread };
+		r->head.store(head + 1, std::memory_order_release);
+	}
+
+	void frame() {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_frame_records.clear();
+		for (auto it = _rings.begin(); it != _rings.end();) {
+			auto &r = *it;
+
+			// Read before draining: everything the exited thread pushed is
+			// visible once its retirement is.
+			auto retired = r->retired.load(std::memory_order_acquire);
+
+			auto tail = r->tail.load(std::memory_order_relaxed);
+			auto head = r->head.load(std::memory_order_acquire);
+			for (; tail != head; ++tail) {
+				_frame_records.push_back(r->records[tail & (ring_capacity - 1)]);
+			}
+			r->tail.store(tail, std::memory_order_release);
+			_dropped += r->dropped.exchange(0, std::memory_order_relaxed);
+
+			it = retired ? _rings.erase(it) : (it + 1);
+		}
+
+		if (_capturing) {
+			_captured.insert(_captured.end(), _frame_records.begin(), _frame_records.end());
+		}
+
+		aggregate();
+	}
+
+	const std::vector<zone_stats> &stats() const noexcept { return _stats; }
+
+	const std::vector<record> &frame_records() const noexcept { return _frame_records; }
+
+	std::size_t dropped() const noexcept { return _dropped; }
+
+	void capture(bool b) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_capturing = b;
+	}
+
+	bool capturing() const noexcept { return _capturing; }
+
+	void clear_capture() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_captured.clear();
+	}
+
+	double to_ms(Uint64 ticks) const noexcept { return static_cast<double>(ticks) * 1000.0 / static_cast<double>(_frequency); }
+
+	double to_us(Uint64 ticks) const noexcept { return static_cast<double>(ticks) * 1000000.0 / static_cast<double>(_frequency); }
+
+	std::string chrome_trace() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		std::string result = "{\"traceEvents\":[";
+		char buffer[128];
+		bool first = true;
+		for (auto &r : _captured) {
+			if (!first) result += ",";
+			first = false;
+
+			result += "{\"name\":\"";
+			for (auto p = r.name; (p != nullptr) && (*p != '\0'); ++p) {
+				if ((*p == '"') || (*p == '\\')) {
+					result += '\\';
+					result += *p;
+				} else if (static_cast<unsigned char>(*p) < 0x20) {
+					std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(*p));
+					result += buffer;
+				} else {
+					result += *p;
+				}
+			}
+			std::snprintf(
+				buffer, sizeof(buffer),
+				"\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+				to_us((r.begin > _origin) ? (r.begin - _origin) : 0), to_us(r.end - r.begin), static_cast<unsigned int>(r.thread)
+			);
+			result += buffer;
+		}
+		result += "]}";
+		return result;
+	}
+
+	bool save_chrome_trace(const char *path) const {
+		auto json = chrome_trace();
+		auto rw = SDL_RWFromFile(path, "wb");
+		if (rw == nullptr) return false;
+
+		bool result = (SDL_RWwrite(rw, json.data(), 1, json.size()) == json.size());
+		return (SDL_RWclose(rw) == 0) && result;
+	}
+
+private:
+	struct ring {
+		std::atomic<Uint64> head { 0 };
+		char padding[sdl::cpu::safe_cache_line_size];
+		std::atomic<Uint64> tail { 0 };
+		std::atomic<std::size_t> dropped { 0 };
+		std::atomic<bool> retired { false };
+		Uint32 thread = 0;
+		record records[ring_capacity];
+	};
+
+	// Retires the calling thread's ring when the thread exits; frame()
+	// frees it after the final drain.
+	struct ring_owner {
+		ring *current = nullptr;
+
+		~ring_owner() {
+			if (current != nullptr) current->retired.store(true, std::memory_order_release);
+		}
+	};
+
+	profiler() : _frequency(peformance_frequency()), _origin(peformance_counter()) {}
+
+	ring *local_ring() noexcept {
+		static thread_local ring_owner owner;
+		if (owner.current == nullptr) {
+			try {
+				std::lock_guard<std::mutex> lock(_mutex);
+				_rings.emplace_back(std::make_unique<ring>());
+				owner.current = _rings.back().get();
+				owner.current->thread = _next_thread++;
+			} catch (...) {
+				return nullptr;
+			}
+		}
+		return owner.current;
+	}
+
+	void aggregate() {
+		_samples.clear();
+		for (auto &r : _frame_records) {
+			_samples[r.name].push_back(r.end - r.begin);
+		}
+
+		_stats.clear();
+		for (auto &it : _samples) {
+			auto &samples = it.second;
+
+			zone_stats s;
+			s.name = it.first;
+			s.count = samples.size();
+
+			Uint64 total = 0;
+			for (auto d : samples) total += d;
+
+			auto p99 = std::min(samples.size() - 1, (samples.size() * 99) / 100);
+			std::nth_element(samples.begin(), samples.begin() + p99, samples.end());
+
+			s.total_ms = to_ms(total);
+			s.min_ms = to_ms(*std::min_element(samples.begin(), samples.end()));
+			s.max_ms = to_ms(*std::max_element(samples.begin(), samples.end()));
+			s.avg_ms = s.total_ms / static_cast<double>(s.count);
+			s.p99_ms = to_ms(samples[p99]);
+			_stats.push_back(s);
+		}
+
+		std::sort(_stats.begin(), _stats.end(), [](const zone_stats &a, const zone_stats &b) { return a.total_ms > b.total_ms; });
+	}
+
+private:
+	mutable std::mutex _mutex;
+	Uint64 _frequency;
+	Uint64 _origin;
+	std::vector<std::unique_ptr<ring>> _rings;
+	std::vector<record> _frame_records;
+	std::vector<record> _captured;
+	std::unordered_map<const char *, std::vector<Uint64>> _samples;
+	std::vector<zone_stats> _stats;
+	std::size_t _dropped = 0;
+	Uint32 _next_thread = 0;
+	bool _capturing = false;
+};
+
+class profile_zone final {
+public:
+	// Touching the profiler first fixes its trace origin before any zone begins.
+	explicit profile_zone(const char *name) noexcept : _profiler(profiler::instance()), _name(name), _begin(peformance_counter()) {}
+
+	profile_zone(const profile_zone &) = delete;
+
+	profile_zone &operator =(const profile_zone &) = delete;
+
+	~profile_zone() { _profiler.push(_name, _begin, peformance_counter()); }
+
+private:
+	profiler &_profiler;
+	const char *_name;
+	Uint64 _begin;
+};
+
+} } // namespace sdl::timer
+
+#define SDL2_WRAPPER_PROFILE_CONCAT_IMPL(a, b) a ## b
+#define SDL2_WRAPPER_PROFILE_CONCAT(a, b) SDL2_WRAPPER_PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(SDL2_WRAPPER_ENABLE_PROFILE)
+#define SDL2_WRAPPER_PROFILE_ZONE(name) ::sdl::timer::profile_zone SDL2_WRAPPER_PROFILE_CONCAT(sdl2_wrapper_profile_zone_, __LINE__)(name)
+#define SDL2_WRAPPER_PROFILE_FRAME() ::sdl::timer::profiler::instance().frame()
+#else
+#define SDL2_WRAPPER_PROFILE_ZONE(name) ((void)0)
+#define SDL2_WRAPPER_PROFILE_FRAME() ((void)0)
+#endif
+
+#endif // SDL2_WRAPPER_TIMER_PROFILE_HPP_
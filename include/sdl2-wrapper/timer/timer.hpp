@@ -30,6 +30,10 @@ using timer_callback = SDL_TimerCallback;
 
 Uint32 ticks() noexcept { return SDL_GetTicks(); }
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+inline Uint64 ticks64() noexcept { return SDL_GetTicks64(); }
+#endif
+
 template <typename T, typename U>
 inline bool ticks_passed(T a, T b) noexcept { return SDL_TICKS_PASSED(a, b); }
 
@@ -0,0 +1,290 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_TIMER_TIMER_WHEEL_HPP_
+#define SDL2_WRAPPER_TIMER_TIMER_WHEEL_HPP_
+
+#include <array>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace sdl { namespace timer {
+
+class timer_wheel final {
+public:
+	using callback = std::function<Uint32 (Uint32 interval)>;
+	using time_type = Uint64;
+
+	static constexpr unsigned int slot_bits = 6;
+	static constexpr unsigned int slot_count = 1u << slot_bits;
+	static constexpr unsigned int level_count = 4;
+
+	struct handle {
+		Uint32 index = invalid_index;
+		Uint32 generation = 0;
+
+		explicit operator bool() const noexcept { return (index != invalid_index); }
+	};
+
+public:
+	explicit timer_wheel(time_type now = clock()) : _current(now) {
+		for (auto &level : _slots) level.fill(Uint32(invalid_index));
+	}
+
+	handle add(Uint32 interval, callback fn) {
+		auto index = allocate();
+		auto &n = _nodes[index];
+		n.fn = std::move(fn);
+		n.interval = interval;
+		n.expires = _current + ((interval != 0) ? interval : 1);
+		insert(index);
+		return handle { index, n.generation };
+	}
+
+	handle add_once(Uint32 delay, std::function<void ()> fn) {
+		return add(delay, [fn](Uint32) { fn(); return 0u; });
+	}
+
+	bool remove(handle h) {
+		if (!valid(h)) return false;
+
+		auto &n = _nodes[h.index];
+		if (n.executing) {
+			n.cancelled = true;
+		} else {
+			unlink(h.index);
+			release(h.index);
+		}
+		return true;
+	}
+
+	bool valid(handle h) const noexcept {
+		return (h.index < _nodes.size()) && (_nodes[h.index].generation == h.generation) && _nodes[h.index].active && !_nodes[h.index].cancelled;
+	}
+
+	std::size_t size() const noexcept { return _active; }
+
+	time_type now() const noexcept { return _current; }
+
+	// Advances to the SDL tick count. Without SDL_GetTicks64 the 32-bit
+	// count is followed by unsigned deltas, so its 49.7 day wrap is harmless.
+	std::size_t advance() {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+		return advance(ticks64());
+#else
+		auto now = ticks();
+		auto elapsed = static_cast<Uint32>(now - _ticks);
+		_ticks = now;
+		return advance(_current + elapsed);
+#endif
+	}
+
+	std::size_t advance(time_type now) {
+		std::size_t fired = 0;
+		while (_current < now) {
+			++_current;
+
+			for (unsigned int level = level_count - 1; level > 0; --level) {
+				auto shift = slot_bits * level;
+				if ((_current & ((time_type(1) << shift) - 1)) == 0) {
+					cascade(level, static_cast<unsigned int>((_current >> shift) & (slot_count - 1)));
+				}
+			}
+
+			fired += fire(static_cast<unsigned int>(_current & (slot_count - 1)));
+		}
+		return fired;
+	}
+
+	void clear() {
+		for (auto &level : _slots) level.fill(Uint32(invalid_index));
+		_nodes.clear();
+		_free = invalid_index;
+		_active = 0;
+	}
+
+private:
+	static constexpr Uint32 invalid_index = std::numeric_limits<Uint32>::max();
+	static constexpr Uint32 firing_list = std::numeric_limits<Uint32>::max() - 1;
+
+	static time_type clock() noexcept {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+		return ticks64();
+#else
+		return ticks();
+#endif
+	}
+
+	struct node {
+		callback fn;
+		time_type expires = 0;
+		Uint32 interval = 0;
+		Uint32 generation = 0;
+		Uint32 prev = invalid_index;
+		Uint32 next = invalid_index;
+		Uint32 list = invalid_index;
+		bool active = false;
+		bool executing = false;
+		bool cancelled = false;
+	};
+
+	Uint32 allocate() {
+		Uint32 index;
+		if (_free != invalid_index) {
+			index = _free;
+			_free = _nodes[index].next;
+		} else {
+			index = static_cast<Uint32>(_nodes.size());
+			_nodes.emplace_back();
+		}
+
+		auto &n = _nodes[index];
+		n.prev = n.next = n.list = invalid_index;
+		n.active = true;
+		n.executing = n.cancelled = false;
+		++_active;
+		return index;
+	}
+
+	void release(Uint32 index) {
+		auto &n = _nodes[index];
+		n.fn = nullptr;
+		n.active = false;
+		n.executing = n.cancelled = false;
+		++n.generation;
+		n.prev = n.list = invalid_index;
+		n.next = _free;
+		_free = index;
+		--_active;
+	}
+
+	Uint32 &head(Uint32 list) noexcept {
+		return (list == firing_list) ? _firing : _slots[list / slot_count][list % slot_count];
+	}
+
+	void link(Uint32 index, Uint32 list) {
+		auto &n = _nodes[index];
+		auto &h = head(list);
+		n.list = list;
+		n.prev = invalid_index;
+		n.next = h;
+		if (h != invalid_index) _nodes[h].prev = index;
+		h = index;
+	}
+
+	void unlink(Uint32 index) {
+		auto &n = _nodes[index];
+		if (n.list == invalid_index) return;
+
+		if (n.prev != invalid_index) {
+			_nodes[n.prev].next = n.next;
+		} else {
+			head(n.list) = n.next;
+		}
+		if (n.next != invalid_index) _nodes[n.next].prev = n.prev;
+
+		n.prev = n.next = n.list = invalid_index;
+	}
+
+	void insert(Uint32 index) {
+		auto &n = _nodes[index];
+		if (n.expires < _current) n.expires = _current;
+
+		auto delta = n.expires - _current;
+		unsigned int level = 0;
+		while ((level + 1 < level_count) && (delta >= (time_type(1) << (slot_bits * (level + 1))))) ++level;
+
+		auto expires = n.expires;
+		auto limit = _current + (time_type(1) << (slot_bits * level_count)) - 1;
+		if (expires > limit) expires = limit;
+
+		auto slot = static_cast<Uint32>((expires >> (slot_bits * level)) & (slot_count - 1));
+		link(index, level * slot_count + slot);
+	}
+
+	void cascade(unsigned int level, unsigned int slot) {
+		auto &h = _slots[level][slot];
+		auto index = h;
+		h = invalid_index;
+
+		while (index != invalid_index) {
+			auto next = _nodes[index].next;
+			_nodes[index].prev = _nodes[index].next = _nodes[index].list = invalid_index;
+			insert(index);
+			index = next;
+		}
+	}
+
+	std::size_t fire(unsigned int slot) {
+		std::size_t fired = 0;
+
+		auto &h = _slots[0][slot];
+		while (h != invalid_index) {
+			auto index = h;
+			unlink(index);
+			if (_nodes[index].expires > _current) {
+				insert(index);
+				continue;
+			}
+			link(index, firing_list);
+		}
+
+		while (_firing != invalid_index) {
+			auto index = _firing;
+			unlink(index);
+
+			auto fn = std::move(_nodes[index].fn);
+			_nodes[index].executing = true;
+
+			auto next = fn ? fn(_nodes[index].interval) : 0u;
+			++fired;
+
+			auto &n = _nodes[index];
+			n.executing = false;
+			if (n.cancelled || (next == 0)) {
+				release(index);
+			} else {
+				n.fn = std::move(fn);
+				n.interval = next;
+				n.expires = _current + next;
+				insert(index);
+			}
+		}
+
+		return fired;
+	}
+
+private:
+	std::array<std::array<Uint32, slot_count>, level_count> _slots;
+	std::vector<node> _nodes;
+	Uint32 _firing = invalid_index;
+	Uint32 _free = invalid_index;
+	std::size_t _active = 0;
+	time_type _current;
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+	Uint32 _ticks = ticks();
+#endif
+};
+
+} } // namespace sdl::timer
+
+#endif // SDL2_WRAPPER_TIMER_TIMER_WHEEL_HPP_
@@ -33,13 +33,26 @@
 #include "video/color.hpp"
 #include "video/palette.hpp"
 #include "video/pixel_format.hpp"
+#include "video/pixel_converter.hpp"
+#include "video/pixel_format_traits.hpp"
 
 // SDL_surface.h
 #include "video/surface.hpp"
+#include "video/surface_view.hpp"
+#include "video/palette_quantizer.hpp"
+#include "video/sprite_store.hpp"
+#include "video/image_encoder.hpp"
+#include "video/image_loader.hpp"
 
 // SDL_render.h
 #include "video/renderer.hpp"
 #include "video/texture.hpp"
+#include "video/texture_manager.hpp"
+#include "video/sprite_batch.hpp"
+#include "video/tilemap_renderer.hpp"
+#include "video/glyph_atlas.hpp"
+#include "video/offscreen_target.hpp"
+#include "video/frame_capture.hpp"
 
 // SDL_video.h
 #include "video/video_driver.hpp"
@@ -0,0 +1,253 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_FRAME_CAPTURE_HPP_
+#define SDL2_WRAPPER_VIDEO_FRAME_CAPTURE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class frame_capture final {
+public:
+	using encoding = image_encoder::format;
+
+	struct statistics {
+		Uint64 captured = 0;
+		Uint64 dropped = 0;
+		Uint64 written = 0;
+		Uint64 failed = 0;
+		Uint64 bytes = 0;
+		Uint64 stall = 0;
+		Uint64 last_stall = 0;
+	};
+
+public:
+	explicit frame_capture(encoding mode = encoding::png, unsigned int threads = 1, std::size_t buffers = 4, bool wait_when_busy = false)
+		: _encoding(mode), _buffers(std::max<std::size_t>(buffers, 1)), _wait(wait_when_busy) {
+		for (unsigned int i = 0; i < std::max(threads, 1U); ++i) {
+			_threads.emplace_back([this] { work(); });
+		}
+	}
+
+	frame_capture(const frame_capture &) = delete;
+
+	frame_capture &operator =(const frame_capture &) = delete;
+
+	~frame_capture() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_queued.notify_all();
+		for (auto &t : _threads) t.join();
+	}
+
+	encoding mode() const noexcept { return _encoding; }
+
+	int effort() const noexcept { return _effort.load(std::memory_order_relaxed); }
+
+	void effort(int value) noexcept { _effort.store(value, std::memory_order_relaxed); }
+
+	bool capture(renderer &renderer, const std::string &path, const SDL_Rect *area = nullptr) {
+		auto start = SDL_GetPerformanceCounter();
+
+		rect bounds;
+		if (area != nullptr) {
+			bounds = *area;
+		} else {
+			auto size = renderer.output_size();
+			bounds = rect(0, 0, size.x, size.y);
+		}
+		if ((bounds.w <= 0) || (bounds.h <= 0)) return false;
+
+		job j;
+		j.path = path;
+		j.width = bounds.w;
+		j.height = bounds.h;
+		j.pitch = bounds.w * 4;
+		j.format = SDL_PIXELFORMAT_RGBA32;
+		if (!acquire(j.pixels, static_cast<std::size_t>(j.pitch) * static_cast<std::size_t>(j.height))) return finish(start, false);
+
+		if (!renderer.read_pixels(&bounds, j.format, j.pixels.data(), j.pitch)) {
+			recycle(std::move(j.pixels));
+			return finish(start, false);
+		}
+		return finish(start, submit(std::move(j)));
+	}
+
+	bool capture(offscreen_target::frame &&frame, const std::string &path) {
+		auto start = SDL_GetPerformanceCounter();
+		if (!frame.valid()) return finish(start, false);
+
+		job j;
+		j.path = path;
+		j.width = frame.w();
+		j.height = frame.h();
+		j.pitch = frame.pitch();
+		j.format = frame.format();
+		j.frame = std::make_unique<offscreen_target::frame>(std::move(frame));
+		return finish(start, submit(std::move(j)));
+	}
+
+	void flush() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_idle.wait(lock, [this] { return _jobs.empty() && (_active == 0); });
+	}
+
+	statistics stats() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _stats;
+	}
+
+private:
+	struct job {
+		std::string path;
+		std::vector<Uint8> pixels;
+		std::unique_ptr<offscreen_target::frame> frame;
+		int width = 0;
+		int height = 0;
+		int pitch = 0;
+		Uint32 format = SDL_PIXELFORMAT_UNKNOWN;
+	};
+
+	bool finish(Uint64 start, bool result) {
+		auto elapsed = SDL_GetPerformanceCounter() - start;
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (result) {
+			++_stats.captured;
+		} else {
+			++_stats.dropped;
+		}
+		_stats.stall += elapsed;
+		_stats.last_stall = elapsed;
+		return result;
+	}
+
+	bool acquire(std::vector<Uint8> &buffer, std::size_t size) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_wait) {
+			_recycled.wait(lock, [this] { return !_free.empty() || (_allocated < _buffers); });
+		} else if (_free.empty() && (_allocated >= _buffers)) {
+			return false;
+		}
+
+		if (!_free.empty()) {
+			buffer = std::move(_free.back());
+			_free.pop_back();
+		} else {
+			++_allocated;
+		}
+		lock.unlock();
+
+		buffer.resize(size);
+		return true;
+	}
+
+	void recycle(std::vector<Uint8> &&buffer) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_free.push_back(std::move(buffer));
+		}
+		_recycled.notify_one();
+	}
+
+	bool submit(job &&j) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_jobs.push_back(std::move(j));
+		}
+		_queued.notify_one();
+		return true;
+	}
+
+	void work() {
+		std::vector<Uint8> encoded;
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (true) {
+			_queued.wait(lock, [this] { return _stop || !_jobs.empty(); });
+			if (_jobs.empty()) break;
+
+			auto j = std::move(_jobs.front());
+			_jobs.pop_front();
+			++_active;
+			lock.unlock();
+
+			encoded.clear();
+			auto pixels = j.frame ? j.frame->pixels() : j.pixels.data();
+			auto result = image_encoder::encode(_encoding, pixels, j.width, j.height, j.pitch, j.format, encoded, effort()) && write(j.path, encoded);
+
+			if (j.frame) {
+				j.frame.reset();
+			} else {
+				recycle(std::move(j.pixels));
+			}
+
+			lock.lock();
+			--_active;
+			if (result) {
+				++_stats.written;
+				_stats.bytes += encoded.size();
+			} else {
+				++_stats.failed;
+			}
+			if (_jobs.empty() && (_active == 0)) _idle.notify_all();
+		}
+	}
+
+	static bool write(const std::string &path, const std::vector<Uint8> &data) noexcept {
+		auto file = SDL_RWFromFile(path.c_str(), "wb");
+		if (file == nullptr) return false;
+
+		auto written = SDL_RWwrite(file, data.data(), 1, data.size());
+		return (SDL_RWclose(file) == 0) && (written == data.size());
+	}
+
+private:
+	const encoding _encoding;
+	std::atomic<int> _effort { 16 };
+	const std::size_t _buffers;
+	const bool _wait;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _queued;
+	std::condition_variable _recycled;
+	std::condition_variable _idle;
+	std::deque<job> _jobs;
+	std::vector<std::vector<Uint8>> _free;
+	std::size_t _allocated = 0;
+	std::size_t _active = 0;
+	bool _stop = false;
+	std::vector<std::thread> _threads;
+	statistics _stats;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_FRAME_CAPTURE_HPP_
@@ -0,0 +1,349 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_GLYPH_ATLAS_HPP_
+#define SDL2_WRAPPER_VIDEO_GLYPH_ATLAS_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class glyph_atlas final {
+public:
+	struct glyph {
+		rect source;
+		int offset = 0;
+		int advance = 0;
+		bool visible = false;
+	};
+
+public:
+	explicit glyph_atlas(
+		renderer &renderer,
+		surface &sheet,
+		int cell_width,
+		int cell_height,
+		Uint32 first = ' ',
+		bool proportional = true,
+		int spacing = 1
+	) : _cell_width(std::max(cell_width, 1)), _cell_height(std::max(cell_height, 1)), _line_height(_cell_height), _first(first) {
+		build(renderer, sheet, proportional, spacing);
+	}
+
+	explicit glyph_atlas(
+		renderer &renderer,
+		const char *path,
+		int cell_width,
+		int cell_height,
+		Uint32 first = ' ',
+		bool proportional = true,
+		int spacing = 1
+	) : _cell_width(std::max(cell_width, 1)), _cell_height(std::max(cell_height, 1)), _line_height(_cell_height), _first(first) {
+		surface sheet(path);
+		if (sheet.valid()) build(renderer, sheet, proportional, spacing);
+	}
+
+	glyph_atlas(const glyph_atlas &) = delete;
+
+	glyph_atlas &operator =(const glyph_atlas &) = delete;
+
+	bool valid() const noexcept { return _texture && _texture->valid(); }
+
+	SDL_Texture *get() const noexcept { return _texture ? _texture->get() : nullptr; }
+
+	int line_height() const noexcept { return _line_height; }
+
+	void line_height(int height) {
+		_line_height = height;
+		_measured.clear();
+	}
+
+	const glyph *find(Uint32 codepoint) const noexcept {
+		if ((codepoint < _first) || (codepoint - _first >= _glyphs.size())) return nullptr;
+		return &_glyphs[codepoint - _first];
+	}
+
+	void kerning(Uint32 first, Uint32 second, int adjust) {
+		if (adjust == 0) {
+			_kerning.erase(pair(first, second));
+		} else {
+			_kerning[pair(first, second)] = adjust;
+		}
+		_measured.clear();
+	}
+
+	int kerning(Uint32 first, Uint32 second) const noexcept {
+		if (_kerning.empty()) return 0;
+
+		auto it = _kerning.find(pair(first, second));
+		return (it != _kerning.end()) ? it->second : 0;
+	}
+
+	point measure(const std::string &text) {
+		auto it = _measured.find(text);
+		if (it != _measured.end()) return it->second;
+
+		point result { 0, 0 };
+		layout(text, 0, 0, [&result](const glyph &, int x, int, int advance) {
+			result.x = std::max(result.x, x + advance);
+		});
+
+		// Every line counts, including empty trailing ones.
+		if (!text.empty()) result.y = static_cast<int>(std::count(text.begin(), text.end(), '\n') + 1) * _line_height;
+
+		if (_measured.size() >= measure_cache_size) _measured.clear();
+		_measured.emplace(text, result);
+		return result;
+	}
+
+	template <typename Function>
+	void layout(const std::string &text, int x, int y, Function &&fn) const {
+		auto p = text.data();
+		auto end = p + text.size();
+		auto pen_x = x;
+		auto pen_y = y;
+		Uint32 previous = 0;
+
+		while (p != end) {
+			auto codepoint = decode(p, end);
+			if (codepoint == '\n') {
+				pen_x = x;
+				pen_y += _line_height;
+				previous = 0;
+				continue;
+			}
+
+			auto g = find(codepoint);
+			if (g == nullptr) g = find('?');
+			if (g == nullptr) continue;
+
+			if (previous != 0) pen_x += kerning(previous, codepoint);
+			fn(*g, pen_x, pen_y, g->advance);
+			pen_x += g->advance;
+			previous = codepoint;
+		}
+	}
+
+	static Uint32 decode(const char *&p, const char *end) noexcept {
+		auto lead = static_cast<unsigned char>(*p++);
+		if (lead < 0x80) return lead;
+
+		// Stray continuation bytes and leads that can only start overlong or
+		// out of range sequences.
+		if ((lead < 0xC2) || (lead > 0xF4)) return 0xFFFD;
+
+		auto length = (lead >= 0xF0) ? 3 : (lead >= 0xE0) ? 2 : 1;
+		auto extra = length;
+		Uint32 result = lead & (0x3F >> extra);
+		for (; (extra > 0) && (p != end) && ((static_cast<unsigned char>(*p) & 0xC0) == 0x80); --extra) {
+			result = (result << 6) | (static_cast<unsigned char>(*p++) & 0x3F);
+		}
+		if (extra != 0) return 0xFFFD;
+
+		Uint32 minimum = (length == 1) ? 0x80 : (length == 2) ? 0x800 : 0x10000;
+		if ((result < minimum) || (result > 0x10FFFF) || ((result >= 0xD800) && (result <= 0xDFFF))) return 0xFFFD;
+		return result;
+	}
+
+private:
+	static constexpr std::size_t measure_cache_size = 1024;
+
+	static Uint64 pair(Uint32 first, Uint32 second) noexcept { return (static_cast<Uint64>(first) << 32) | second; }
+
+	void build(renderer &renderer, surface &sheet, bool proportional, int spacing) {
+		std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> pixels(sheet.convert_format(SDL_PIXELFORMAT_ARGB8888, 0), SDL_FreeSurface);
+		if (!pixels) return;
+
+		auto columns = pixels->w / _cell_width;
+		auto rows = pixels->h / _cell_height;
+		_glyphs.resize(static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows));
+
+		{
+			surface_lock lock(pixels.get());
+			if (!lock) {
+				_glyphs.clear();
+				return;
+			}
+
+			for (int row = 0; row < rows; ++row) {
+				for (int column = 0; column < columns; ++column) {
+					auto &g = _glyphs[static_cast<std::size_t>(row) * static_cast<std::size_t>(columns) + static_cast<std::size_t>(column)];
+					g.source = rect(column * _cell_width, row * _cell_height, _cell_width, _cell_height);
+					g.advance = _cell_width + spacing;
+					g.visible = true;
+					if (proportional) trim(pixels.get(), g, spacing);
+				}
+			}
+		}
+
+		_texture = std::make_unique<texture>(renderer.get(), pixels.get());
+		if (_texture->valid()) _texture->blend_mode(SDL_BLENDMODE_BLEND);
+	}
+
+	void trim(SDL_Surface *pixels, glyph &g, int spacing) noexcept {
+		auto left = g.source.w;
+		auto right = -1;
+		for (int y = 0; y < g.source.h; ++y) {
+			auto row = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(pixels->pixels) + (g.source.y + y) * pixels->pitch) + g.source.x;
+			for (int x = 0; x < g.source.w; ++x) {
+				if ((row[x] >> 24) == 0) continue;
+
+				left = std::min(left, x);
+				right = std::max(right, x);
+			}
+		}
+
+		if (right < 0) {
+			g.visible = false;
+			g.advance = std::max(_cell_width / 2, 1);
+			return;
+		}
+
+		g.source.x += left;
+		g.source.w = right - left + 1;
+		g.advance = g.source.w + spacing;
+	}
+
+private:
+	std::unique_ptr<texture> _texture;
+	int _cell_width;
+	int _cell_height;
+	int _line_height;
+	Uint32 _first;
+	std::vector<glyph> _glyphs;
+	std::unordered_map<Uint64, int> _kerning;
+	std::unordered_map<std::string, point> _measured;
+};
+
+class text_batch final {
+public:
+	explicit text_batch(glyph_atlas &atlas) : _atlas(atlas) {}
+
+	void add(const std::string &text, int x, int y, const color &tint = color(0xFF, 0xFF, 0xFF)) {
+		_atlas.layout(text, x, y, [this, &tint](const glyph_atlas::glyph &g, int gx, int gy, int) {
+			if (!g.visible) return;
+			_quads.push_back(quad { g.source, rect(gx, gy, g.source.w, g.source.h), tint });
+		});
+	}
+
+	std::size_t size() const noexcept { return _quads.size(); }
+
+	bool empty() const noexcept { return _quads.empty(); }
+
+	void clear() noexcept { _quads.clear(); }
+
+	bool flush(renderer &renderer) {
+		if (_quads.empty()) return true;
+
+		auto texture = _atlas.get();
+		if (texture == nullptr) {
+			clear();
+			return false;
+		}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+		auto result = renderer::geometry_supported() ? flush_geometry(renderer, texture) : flush_copy(renderer, texture);
+#else
+		auto result = flush_copy(renderer, texture);
+#endif
+		clear();
+		return result;
+	}
+
+private:
+	struct quad {
+		rect source;
+		rect destination;
+		color tint;
+	};
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	bool flush_geometry(renderer &renderer, SDL_Texture *texture) {
+		int w = 1, h = 1;
+		SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+		auto sx = 1.0f / static_cast<float>(w);
+		auto sy = 1.0f / static_cast<float>(h);
+
+		_vertices.clear();
+		_indices.clear();
+		_vertices.reserve(_quads.size() * 4);
+		_indices.reserve(_quads.size() * 6);
+		for (auto &q : _quads) {
+			auto base = static_cast<int>(_vertices.size());
+			auto x0 = static_cast<float>(q.destination.x);
+			auto y0 = static_cast<float>(q.destination.y);
+			auto x1 = static_cast<float>(q.destination.x + q.destination.w);
+			auto y1 = static_cast<float>(q.destination.y + q.destination.h);
+			auto u0 = static_cast<float>(q.source.x) * sx;
+			auto v0 = static_cast<float>(q.source.y) * sy;
+			auto u1 = static_cast<float>(q.source.x + q.source.w) * sx;
+			auto v1 = static_cast<float>(q.source.y + q.source.h) * sy;
+
+			_vertices.push_back(SDL_Vertex { { x0, y0 }, q.tint, { u0, v0 } });
+			_vertices.push_back(SDL_Vertex { { x1, y0 }, q.tint, { u1, v0 } });
+			_vertices.push_back(SDL_Vertex { { x1, y1 }, q.tint, { u1, v1 } });
+			_vertices.push_back(SDL_Vertex { { x0, y1 }, q.tint, { u0, v1 } });
+
+			const int indices[] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+			_indices.insert(_indices.end(), std::begin(indices), std::end(indices));
+		}
+
+		return renderer.geometry(texture, _vertices.data(), static_cast<int>(_vertices.size()), _indices.data(), static_cast<int>(_indices.size()));
+	}
+#endif
+
+	bool flush_copy(renderer &renderer, SDL_Texture *texture) noexcept {
+		Uint8 r, g, b, a;
+		SDL_GetTextureColorMod(texture, &r, &g, &b);
+		SDL_GetTextureAlphaMod(texture, &a);
+
+		bool result = true;
+		color current(r, g, b, a);
+		for (auto &q : _quads) {
+			if (q.tint != current) {
+				current = q.tint;
+				SDL_SetTextureColorMod(texture, current.r, current.g, current.b);
+				SDL_SetTextureAlphaMod(texture, current.a);
+			}
+			result &= renderer.copy(texture, &q.source, &q.destination);
+		}
+
+		SDL_SetTextureColorMod(texture, r, g, b);
+		SDL_SetTextureAlphaMod(texture, a);
+		return result;
+	}
+
+private:
+	glyph_atlas &_atlas;
+	std::vector<quad> _quads;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	std::vector<SDL_Vertex> _vertices;
+	std::vector<int> _indices;
+#endif
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_GLYPH_ATLAS_HPP_
@@ -0,0 +1,243 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_IMAGE_ENCODER_HPP_
+#define SDL2_WRAPPER_VIDEO_IMAGE_ENCODER_HPP_
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class image_encoder final {
+public:
+	enum class format {
+		raw,
+		qoi,
+		png,
+	};
+
+	static const char *extension(format f) noexcept {
+		switch (f) {
+		case format::qoi: return ".qoi";
+		case format::png: return ".png";
+		default: return ".raw";
+		}
+	}
+
+	static bool encode(
+		format f,
+		const void *pixels,
+		int width,
+		int height,
+		int pitch,
+		Uint32 pixel_format,
+		std::vector<Uint8> &out,
+		int effort = 16
+	) {
+		if ((pixels == nullptr) || (width <= 0) || (height <= 0)) return false;
+
+		std::vector<Uint8> converted;
+		if (pixel_format != SDL_PIXELFORMAT_RGBA32) {
+			converted.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+			if (!convert_pixels(width, height, pixel_format, pixels, pitch, SDL_PIXELFORMAT_RGBA32, converted.data(), width * 4)) return false;
+
+			pixels = converted.data();
+			pitch = width * 4;
+		}
+
+		auto rgba = static_cast<const Uint8 *>(pixels);
+		switch (f) {
+		case format::qoi:
+			qoi(rgba, width, height, pitch, out);
+			break;
+
+		case format::png:
+			png(rgba, width, height, pitch, out, effort);
+			break;
+
+		default:
+			raw(rgba, width, height, pitch, out);
+			break;
+		}
+		return true;
+	}
+
+	static void raw(const Uint8 *rgba, int width, int height, int pitch, std::vector<Uint8> &out) {
+		out.reserve(out.size() + static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+		for (int y = 0; y < height; ++y) {
+			auto row = rgba + static_cast<std::ptrdiff_t>(y) * pitch;
+			out.insert(out.end(), row, row + width * 4);
+		}
+	}
+
+	static void qoi(const Uint8 *rgba, int width, int height, int pitch, std::vector<Uint8> &out) {
+		out.reserve(out.size() + 14 + static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 2);
+		out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+		put_be32(out, static_cast<Uint32>(width));
+		put_be32(out, static_cast<Uint32>(height));
+		out.push_back(4);
+		out.push_back(0);
+
+		Uint8 index[64][4] = {};
+		Uint8 previous[4] = { 0, 0, 0, 255 };
+		int run = 0;
+
+		for (int y = 0; y < height; ++y) {
+			auto px = rgba + static_cast<std::ptrdiff_t>(y) * pitch;
+			for (int x = 0; x < width; ++x, px += 4) {
+				if (std::memcmp(px, previous, 4) == 0) {
+					if (++run == 62) {
+						out.push_back(static_cast<Uint8>(0xC0 | (run - 1)));
+						run = 0;
+					}
+					continue;
+				}
+
+				if (run > 0) {
+					out.push_back(static_cast<Uint8>(0xC0 | (run - 1)));
+					run = 0;
+				}
+
+				auto slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+				if (std::memcmp(index[slot], px, 4) == 0) {
+					out.push_back(static_cast<Uint8>(slot));
+				} else {
+					std::memcpy(index[slot], px, 4);
+
+					if (px[3] == previous[3]) {
+						auto dr = static_cast<Sint8>(px[0] - previous[0]);
+						auto dg = static_cast<Sint8>(px[1] - previous[1]);
+						auto db = static_cast<Sint8>(px[2] - previous[2]);
+						auto dr_dg = static_cast<Sint8>(dr - dg);
+						auto db_dg = static_cast<Sint8>(db - dg);
+
+						if ((dr >= -2) && (dr <= 1) && (dg >= -2) && (dg <= 1) && (db >= -2) && (db <= 1)) {
+							out.push_back(static_cast<Uint8>(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+						} else if ((dg >= -32) && (dg <= 31) && (dr_dg >= -8) && (dr_dg <= 7) && (db_dg >= -8) && (db_dg <= 7)) {
+							out.push_back(static_cast<Uint8>(0x80 | (dg + 32)));
+							out.push_back(static_cast<Uint8>(((dr_dg + 8) << 4) | (db_dg + 8)));
+						} else {
+							out.insert(out.end(), { 0xFE, px[0], px[1], px[2] });
+						}
+					} else {
+						out.insert(out.end(), { 0xFF, px[0], px[1], px[2], px[3] });
+					}
+				}
+				std::memcpy(previous, px, 4);
+			}
+		}
+
+		if (run > 0) out.push_back(static_cast<Uint8>(0xC0 | (run - 1)));
+		out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+	}
+
+	static void png(const Uint8 *rgba, int width, int height, int pitch, std::vector<Uint8> &out, int effort = 16) {
+		auto stride = static_cast<std::size_t>(width) * 4;
+		std::vector<Uint8> filtered((stride + 1) * static_cast<std::size_t>(height));
+		std::vector<Uint8> candidate(stride);
+
+		for (int y = 0; y < height; ++y) {
+			auto row = rgba + static_cast<std::ptrdiff_t>(y) * pitch;
+			auto above = (y > 0) ? (row - pitch) : nullptr;
+			auto target = filtered.data() + (stride + 1) * static_cast<std::size_t>(y);
+
+			unsigned long best_score = ~0UL;
+			for (Uint8 type = 0; type < 5; ++type) {
+				unsigned long score = 0;
+				for (std::size_t i = 0; i < stride; ++i) {
+					int a = (i >= 4) ? row[i - 4] : 0;
+					int b = (above != nullptr) ? above[i] : 0;
+					int c = ((i >= 4) && (above != nullptr)) ? above[i - 4] : 0;
+
+					auto value = static_cast<Uint8>(row[i] - predict(type, a, b, c));
+					candidate[i] = value;
+					score += static_cast<unsigned long>(std::abs(static_cast<Sint8>(value)));
+				}
+				if (score < best_score) {
+					best_score = score;
+					target[0] = type;
+					std::memcpy(target + 1, candidate.data(), stride);
+				}
+			}
+		}
+
+		out.insert(out.end(), { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' });
+
+		Uint8 header[13];
+		put_be32(header, static_cast<Uint32>(width));
+		put_be32(header + 4, static_cast<Uint32>(height));
+		header[8] = 8;
+		header[9] = 6;
+		header[10] = 0;
+		header[11] = 0;
+		header[12] = 0;
+		chunk(out, "IHDR", header, sizeof(header));
+
+		std::vector<Uint8> compressed;
+		detail::zlib::compress(filtered.data(), filtered.size(), compressed, effort);
+		chunk(out, "IDAT", compressed.data(), compressed.size());
+		chunk(out, "IEND", nullptr, 0);
+	}
+
+	static int predict(int type, int a, int b, int c) noexcept {
+		switch (type) {
+		case 1: return a;
+		case 2: return b;
+		case 3: return (a + b) / 2;
+		case 4: {
+			auto p = a + b - c;
+			auto pa = std::abs(p - a);
+			auto pb = std::abs(p - b);
+			auto pc = std::abs(p - c);
+			return ((pa <= pb) && (pa <= pc)) ? a : (pb <= pc) ? b : c;
+		}
+		default: return 0;
+		}
+	}
+
+private:
+	static void put_be32(Uint8 *out, Uint32 value) noexcept {
+		out[0] = static_cast<Uint8>(value >> 24);
+		out[1] = static_cast<Uint8>(value >> 16);
+		out[2] = static_cast<Uint8>(value >> 8);
+		out[3] = static_cast<Uint8>(value);
+	}
+
+	static void put_be32(std::vector<Uint8> &out, Uint32 value) {
+		Uint8 bytes[4];
+		put_be32(bytes, value);
+		out.insert(out.end(), bytes, bytes + 4);
+	}
+
+	static void chunk(std::vector<Uint8> &out, const char *type, const Uint8 *data, std::size_t size) {
+		put_be32(out, static_cast<Uint32>(size));
+		auto start = out.size();
+		out.insert(out.end(), type, type + 4);
+		if (size > 0) out.insert(out.end(), data, data + size);
+		put_be32(out, detail::crc32::hash(out.data() + start, out.size() - start));
+	}
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_IMAGE_ENCODER_HPP_
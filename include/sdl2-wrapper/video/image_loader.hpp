@@ -0,0 +1,555 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_IMAGE_LOADER_HPP_
+#define SDL2_WRAPPER_VIDEO_IMAGE_LOADER_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class image_loader final {
+public:
+	using probe = std::function<bool (const Uint8 *data, std::size_t size)>;
+	using decoder = std::function<std::unique_ptr<surface> (const Uint8 *data, std::size_t size, Uint32 format, task_system *tasks)>;
+
+	static constexpr std::size_t parallel_threshold = 1 << 16;
+
+	static void add(const std::string &name, probe test, decoder decode) {
+		auto &r = instance();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.codecs.erase(std::remove_if(r.codecs.begin(), r.codecs.end(), [&name](const codec &c) { return c.name == name; }), r.codecs.end());
+		r.codecs.insert(r.codecs.begin(), codec { name, std::move(test), std::move(decode) });
+	}
+
+	static bool remove(const std::string &name) {
+		auto &r = instance();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		auto it = std::find_if(r.codecs.begin(), r.codecs.end(), [&name](const codec &c) { return c.name == name; });
+		if (it == r.codecs.end()) return false;
+
+		r.codecs.erase(it);
+		return true;
+	}
+
+	static std::unique_ptr<surface> load(const void *data, std::size_t size, Uint32 format = SDL_PIXELFORMAT_ARGB8888, task_system *tasks = nullptr) {
+		auto bytes = static_cast<const Uint8 *>(data);
+
+		decoder decode;
+		{
+			auto &r = instance();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			for (auto &c : r.codecs) {
+				if (c.test(bytes, size)) {
+					decode = c.decode;
+					break;
+				}
+			}
+		}
+
+		if (!decode) {
+			SDL_SetError("Unsupported image format");
+			return nullptr;
+		}
+		return decode(bytes, size, format, tasks);
+	}
+
+	static std::unique_ptr<surface> load(SDL_RWops *src, int freesrc, Uint32 format = SDL_PIXELFORMAT_ARGB8888, task_system *tasks = nullptr) {
+		if (src == nullptr) return nullptr;
+
+		std::vector<Uint8> data;
+		auto size = SDL_RWsize(src);
+		if (size > 0) {
+			data.resize(static_cast<std::size_t>(size));
+			data.resize(SDL_RWread(src, data.data(), 1, data.size()));
+		} else {
+			Uint8 block[4096];
+			for (std::size_t n; (n = SDL_RWread(src, block, 1, sizeof(block))) > 0; ) data.insert(data.end(), block, block + n);
+		}
+		if (freesrc != 0) SDL_RWclose(src);
+
+		return load(data.data(), data.size(), format, tasks);
+	}
+
+	static std::unique_ptr<surface> load(const char *file, Uint32 format = SDL_PIXELFORMAT_ARGB8888, task_system *tasks = nullptr) {
+		return load(SDL_RWFromFile(file, "rb"), 1, format, tasks);
+	}
+
+	static bool is_bmp(const Uint8 *data, std::size_t size) noexcept {
+		return (size >= 2) && (data[0] == 'B') && (data[1] == 'M');
+	}
+
+	static bool is_qoi(const Uint8 *data, std::size_t size) noexcept {
+		return (size >= 14) && (std::memcmp(data, "qoif", 4) == 0);
+	}
+
+	static bool is_png(const Uint8 *data, std::size_t size) noexcept {
+		static const Uint8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		return (size >= 8) && (std::memcmp(data, signature, sizeof(signature)) == 0);
+	}
+
+	static std::unique_ptr<surface> load_bmp(const Uint8 *data, std::size_t size, Uint32 format, task_system *) {
+		std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> bmp(
+			SDL_LoadBMP_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1),
+			SDL_FreeSurface
+		);
+		if (!bmp) return nullptr;
+
+		auto result = create(bmp->w, bmp->h, format);
+		if (!result) return nullptr;
+
+		SDL_SetSurfaceBlendMode(bmp.get(), SDL_BLENDMODE_NONE);
+		if (SDL_BlitSurface(bmp.get(), nullptr, result->get(), nullptr) != 0) return nullptr;
+		return result;
+	}
+
+	static std::unique_ptr<surface> load_qoi(const Uint8 *data, std::size_t size, Uint32 format, task_system *tasks) {
+		if (!is_qoi(data, size)) {
+			SDL_SetError("Not a QOI image");
+			return nullptr;
+		}
+
+		auto width = static_cast<int>(read_be32(data + 4));
+		auto height = static_cast<int>(read_be32(data + 8));
+		auto result = create(width, height, format);
+		if (!result) return nullptr;
+
+		row_writer rows(*result, tasks);
+		Uint8 index[64][4] = {};
+		Uint8 px[4] = { 0, 0, 0, 255 };
+		std::size_t p = 14;
+		std::size_t end = (size >= 8) ? (size - 8) : 0;
+		int run = 0;
+
+		for (int y = 0; y < height; ++y) {
+			auto out = rows.row(y);
+			for (int x = 0; x < width; ++x, out += 4) {
+				if (run > 0) {
+					--run;
+				} else {
+					if (p >= end) return truncated("QOI");
+
+					auto b = data[p++];
+					if (b == 0xFE) {
+						if (p + 3 > end) return truncated("QOI");
+						px[0] = data[p++];
+						px[1] = data[p++];
+						px[2] = data[p++];
+					} else if (b == 0xFF) {
+						if (p + 4 > end) return truncated("QOI");
+						std::memcpy(px, data + p, 4);
+						p += 4;
+					} else {
+						switch (b >> 6) {
+						case 0:
+							std::memcpy(px, index[b], 4);
+							break;
+
+						case 1:
+							px[0] = static_cast<Uint8>(px[0] + ((b >> 4) & 3) - 2);
+							px[1] = static_cast<Uint8>(px[1] + ((b >> 2) & 3) - 2);
+							px[2] = static_cast<Uint8>(px[2] + (b & 3) - 2);
+							break;
+
+						case 2: {
+							if (p + 1 > end) return truncated("QOI");
+							auto b2 = data[p++];
+							auto dg = (b & 0x3F) - 32;
+							px[0] = static_cast<Uint8>(px[0] + dg - 8 + (b2 >> 4));
+							px[1] = static_cast<Uint8>(px[1] + dg);
+							px[2] = static_cast<Uint8>(px[2] + dg - 8 + (b2 & 0x0F));
+							break;
+						}
+
+						default:
+							run = b & 0x3F;
+							break;
+						}
+					}
+					std::memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+				}
+				put(out, rows.order(), px[0], px[1], px[2], px[3]);
+			}
+			rows.commit(y);
+		}
+
+		if (!rows.finish()) return nullptr;
+		return result;
+	}
+
+	static std::unique_ptr<surface> load_png(const Uint8 *data, std::size_t size, Uint32 format, task_system *tasks) {
+		if (!is_png(data, size)) {
+			SDL_SetError("Not a PNG image");
+			return nullptr;
+		}
+
+		png_header header;
+		std::vector<Uint8> compressed;
+		Uint8 palette[256][4];
+		for (auto &entry : palette) entry[0] = entry[1] = entry[2] = 0, entry[3] = 0xFF;
+		bool has_key = false;
+		Uint16 key[3] = {};
+
+		for (std::size_t p = 8; p + 12 <= size; ) {
+			auto length = read_be32(data + p);
+			auto type = data + p + 4;
+			auto body = data + p + 8;
+			if (length > size - p - 12) break;
+
+			if (std::memcmp(type, "IHDR", 4) == 0) {
+				if (length < 13) break;
+				header.width = static_cast<int>(read_be32(body));
+				header.height = static_cast<int>(read_be32(body + 4));
+				header.depth = body[8];
+				header.color = body[9];
+				header.interlace = body[12];
+			} else if (std::memcmp(type, "PLTE", 4) == 0) {
+				for (std::size_t i = 0; (i < length / 3) && (i < 256); ++i) {
+					palette[i][0] = body[i * 3];
+					palette[i][1] = body[i * 3 + 1];
+					palette[i][2] = body[i * 3 + 2];
+				}
+			} else if (std::memcmp(type, "tRNS", 4) == 0) {
+				if (header.color == 3) {
+					for (std::size_t i = 0; (i < length) && (i < 256); ++i) palette[i][3] = body[i];
+				} else if ((header.color == 0) && (length >= 2)) {
+					has_key = true;
+					key[0] = key[1] = key[2] = read_be16(body);
+				} else if ((header.color == 2) && (length >= 6)) {
+					has_key = true;
+					for (int i = 0; i < 3; ++i) key[i] = read_be16(body + i * 2);
+				}
+			} else if (std::memcmp(type, "IDAT", 4) == 0) {
+				compressed.insert(compressed.end(), body, body + length);
+			} else if (std::memcmp(type, "IEND", 4) == 0) {
+				break;
+			}
+			p += length + 12;
+		}
+
+		if (!header.valid()) {
+			SDL_SetError("Unsupported PNG image");
+			return nullptr;
+		}
+
+		auto result = create(header.width, header.height, format);
+		if (!result) return nullptr;
+
+		auto stride = header.stride();
+		auto expected = (stride + 1) * static_cast<std::size_t>(header.height);
+		std::vector<Uint8> raw;
+		raw.reserve(expected);
+		if (!detail::zlib::decompress(compressed.data(), compressed.size(), raw, expected) || (raw.size() < expected)) {
+			SDL_SetError("Corrupt PNG image data");
+			return nullptr;
+		}
+		compressed = std::vector<Uint8>();
+
+		auto filter_bytes = std::max<std::size_t>(header.bits() / 8, 1);
+		for (int y = 0; y < header.height; ++y) {
+			auto row = raw.data() + (stride + 1) * static_cast<std::size_t>(y);
+			auto above = (y > 0) ? (row - stride) : nullptr;
+			if (!unfilter(row[0], row + 1, above, stride, filter_bytes)) {
+				SDL_SetError("Corrupt PNG filter type");
+				return nullptr;
+			}
+		}
+
+		channel_order order;
+		auto direct = direct_order(format, order);
+		auto &target = *result;
+		auto expand_rows = [&](int begin, int end) {
+			std::vector<Uint8> scratch(direct ? 0 : static_cast<std::size_t>(header.width) * 4);
+			for (int y = begin; y < end; ++y) {
+				auto out = direct ? target_row(target, y) : scratch.data();
+				expand(header, raw.data() + (stride + 1) * static_cast<std::size_t>(y) + 1, out, order, palette, has_key ? key : nullptr);
+				if (!direct) convert_pixels(header.width, 1, SDL_PIXELFORMAT_RGBA32, out, header.width * 4, format, target_row(target, y), target.pitch());
+			}
+		};
+
+		if ((tasks != nullptr) && (pixel_count(header.width, header.height) >= parallel_threshold)) {
+			tasks->parallel_for(0, header.height, expand_rows);
+		} else {
+			expand_rows(0, header.height);
+		}
+		return result;
+	}
+
+private:
+	struct codec {
+		std::string name;
+		probe test;
+		decoder decode;
+	};
+
+	struct registry {
+		std::mutex mutex;
+		std::vector<codec> codecs;
+	};
+
+	struct png_header {
+		int width = 0;
+		int height = 0;
+		int depth = 0;
+		int color = -1;
+		int interlace = 0;
+
+		int channels() const noexcept {
+			switch (color) {
+			case 0: return 1;
+			case 2: return 3;
+			case 3: return 1;
+			case 4: return 2;
+			case 6: return 4;
+			default: return 0;
+			}
+		}
+
+		std::size_t bits() const noexcept { return static_cast<std::size_t>(channels() * depth); }
+
+		std::size_t stride() const noexcept { return (static_cast<std::size_t>(width) * bits() + 7) / 8; }
+
+		bool valid() const noexcept {
+			if ((width <= 0) || (height <= 0) || (interlace != 0) || (channels() == 0)) return false;
+
+			switch (color) {
+			case 0: return (depth == 1) || (depth == 2) || (depth == 4) || (depth == 8) || (depth == 16);
+			case 3: return (depth == 1) || (depth == 2) || (depth == 4) || (depth == 8);
+			default: return (depth == 8) || (depth == 16);
+			}
+		}
+	};
+
+	// Byte positions of R, G, B and A in a decoded pixel.
+	struct channel_order {
+		int r = 0;
+		int g = 1;
+		int b = 2;
+		int a = 3;
+	};
+
+	// Decoders write the 32-bit byte-order formats in place; any other
+	// target is staged as RGBA32 and converted.
+	static bool direct_order(Uint32 format, channel_order &order) noexcept {
+		switch (format) {
+		case SDL_PIXELFORMAT_RGBA32: order = channel_order { 0, 1, 2, 3 }; return true;
+		case SDL_PIXELFORMAT_BGRA32: order = channel_order { 2, 1, 0, 3 }; return true;
+		case SDL_PIXELFORMAT_ARGB32: order = channel_order { 1, 2, 3, 0 }; return true;
+		case SDL_PIXELFORMAT_ABGR32: order = channel_order { 3, 2, 1, 0 }; return true;
+		default: order = channel_order(); return false;
+		}
+	}
+
+	static void put(Uint8 *out, const channel_order &order, Uint8 r, Uint8 g, Uint8 b, Uint8 a) noexcept {
+		out[order.r] = r;
+		out[order.g] = g;
+		out[order.b] = b;
+		out[order.a] = a;
+	}
+
+	class row_writer final {
+	public:
+		row_writer(surface &target, task_system *tasks)
+			: _target(target), _tasks(tasks), _direct(direct_order(target.format()->format, _order)) {
+			if (_direct) return;
+
+			_staged = (tasks != nullptr) && (pixel_count(target.w(), target.h()) >= parallel_threshold);
+			_buffer.resize(static_cast<std::size_t>(target.w()) * 4 * (_staged ? static_cast<std::size_t>(target.h()) : 1));
+		}
+
+		const channel_order &order() const noexcept { return _order; }
+
+		Uint8 *row(int y) noexcept {
+			if (_direct) return target_row(_target, y);
+			return _buffer.data() + (_staged ? static_cast<std::size_t>(y) * static_cast<std::size_t>(_target.w()) * 4 : 0);
+		}
+
+		void commit(int y) noexcept {
+			if (_direct || _staged) return;
+			if (!convert(y, y + 1)) _ok = false;
+		}
+
+		bool finish() {
+			if (_staged) {
+				_tasks->parallel_for(0, _target.h(), [this](int begin, int end) {
+					if (!convert(begin, end)) _ok = false;
+				});
+			}
+			return _ok;
+		}
+
+	private:
+		bool convert(int begin, int end) noexcept {
+			auto source = _buffer.data() + (_staged ? static_cast<std::size_t>(begin) * static_cast<std::size_t>(_target.w()) * 4 : 0);
+			return convert_pixels(
+				_target.w(), end - begin,
+				SDL_PIXELFORMAT_RGBA32, source, _target.w() * 4,
+				_target.format()->format, target_row(_target, begin), _target.pitch()
+			);
+		}
+
+		surface &_target;
+		task_system *_tasks;
+		channel_order _order;
+		bool _direct;
+		bool _staged = false;
+		std::atomic<bool> _ok { true };
+		std::vector<Uint8> _buffer;
+	};
+
+	static registry &instance() {
+		static registry r { {}, {
+			codec { "png", is_png, load_png },
+			codec { "qoi", is_qoi, load_qoi },
+			codec { "bmp", is_bmp, load_bmp },
+		} };
+		return r;
+	}
+
+	static std::size_t pixel_count(int width, int height) noexcept {
+		return static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+	}
+
+	static Uint8 *target_row(surface &target, int y) noexcept {
+		return static_cast<Uint8 *>(target.pixels()) + static_cast<std::ptrdiff_t>(y) * target.pitch();
+	}
+
+	static std::unique_ptr<surface> create(int width, int height, Uint32 format) {
+		if ((width <= 0) || (height <= 0) || (pixel_count(width, height) > (1U << 28))) {
+			SDL_SetError("Invalid image dimensions");
+			return nullptr;
+		}
+
+		auto result = std::make_unique<surface>(0, width, height, SDL_BITSPERPIXEL(format), format);
+		return result->valid() ? std::move(result) : nullptr;
+	}
+
+	static std::unique_ptr<surface> truncated(const char *type) {
+		SDL_SetError("Truncated %s image", type);
+		return nullptr;
+	}
+
+	static Uint32 read_be32(const Uint8 *p) noexcept {
+		return (static_cast<Uint32>(p[0]) << 24) | (static_cast<Uint32>(p[1]) << 16) | (static_cast<Uint32>(p[2]) << 8) | p[3];
+	}
+
+	static Uint16 read_be16(const Uint8 *p) noexcept { return static_cast<Uint16>((p[0] << 8) | p[1]); }
+
+	static bool unfilter(Uint8 type, Uint8 *row, const Uint8 *above, std::size_t stride, std::size_t bpp) noexcept {
+		switch (type) {
+		case 0:
+			return true;
+
+		case 1:
+			for (std::size_t i = bpp; i < stride; ++i) row[i] = static_cast<Uint8>(row[i] + row[i - bpp]);
+			return true;
+
+		case 2:
+			if (above != nullptr) {
+				for (std::size_t i = 0; i < stride; ++i) row[i] = static_cast<Uint8>(row[i] + above[i]);
+			}
+			return true;
+
+		case 3:
+			for (std::size_t i = 0; i < stride; ++i) {
+				int a = (i >= bpp) ? row[i - bpp] : 0;
+				int b = (above != nullptr) ? above[i] : 0;
+				row[i] = static_cast<Uint8>(row[i] + ((a + b) >> 1));
+			}
+			return true;
+
+		case 4:
+			for (std::size_t i = 0; i < stride; ++i) {
+				int a = (i >= bpp) ? row[i - bpp] : 0;
+				int b = (above != nullptr) ? above[i] : 0;
+				int c = ((i >= bpp) && (above != nullptr)) ? above[i - bpp] : 0;
+				row[i] = static_cast<Uint8>(row[i] + image_encoder::predict(4, a, b, c));
+			}
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	static void expand(const png_header &header, const Uint8 *in, Uint8 *out, const channel_order &order, const Uint8 (*palette)[4], const Uint16 *key) noexcept {
+		auto width = header.width;
+
+		if (header.depth < 8) {
+			auto mask = (1 << header.depth) - 1;
+			auto scale = 255 / mask;
+			for (int x = 0; x < width; ++x, out += 4) {
+				auto bit = x * header.depth;
+				auto value = (in[bit >> 3] >> (8 - header.depth - (bit & 7))) & mask;
+				if (header.color == 3) {
+					auto &entry = palette[value];
+					put(out, order, entry[0], entry[1], entry[2], entry[3]);
+				} else {
+					auto gray = static_cast<Uint8>(value * scale);
+					put(out, order, gray, gray, gray, ((key != nullptr) && (key[0] == value)) ? 0 : 0xFF);
+				}
+			}
+			return;
+		}
+
+		auto step = header.depth / 8;
+		auto channels = header.channels();
+		for (int x = 0; x < width; ++x, out += 4, in += channels * step) {
+			switch (header.color) {
+			case 0:
+				put(out, order, in[0], in[0], in[0], ((key != nullptr) && (key[0] == sample(in, step))) ? 0 : 0xFF);
+				break;
+
+			case 2:
+				put(out, order, in[0], in[step], in[step * 2],
+					((key != nullptr) && (key[0] == sample(in, step)) && (key[1] == sample(in + step, step)) && (key[2] == sample(in + step * 2, step))) ? 0 : 0xFF);
+				break;
+
+			case 3: {
+				auto &entry = palette[in[0]];
+				put(out, order, entry[0], entry[1], entry[2], entry[3]);
+				break;
+			}
+
+			case 4:
+				put(out, order, in[0], in[0], in[0], in[step]);
+				break;
+
+			default:
+				put(out, order, in[0], in[step], in[step * 2], in[step * 3]);
+				break;
+			}
+		}
+	}
+
+	static Uint16 sample(const Uint8 *p, int step) noexcept { return (step == 2) ? read_be16(p) : p[0]; }
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_IMAGE_LOADER_HPP_
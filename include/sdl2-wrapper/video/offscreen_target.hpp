@@ -0,0 +1,215 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_OFFSCREEN_TARGET_HPP_
+#define SDL2_WRAPPER_VIDEO_OFFSCREEN_TARGET_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class offscreen_target final {
+private:
+	struct buffer;
+
+public:
+	class frame final {
+	public:
+		frame() noexcept = default;
+
+		frame(const frame &) = delete;
+
+		frame(frame &&rhs) noexcept : _owner(rhs._owner), _buffer(rhs._buffer) { rhs._owner = nullptr; }
+
+		~frame() { release(); }
+
+		frame &operator =(const frame &) = delete;
+
+		frame &operator =(frame &&rhs) noexcept {
+			if (this != &rhs) {
+				release();
+				_owner = rhs._owner;
+				_buffer = rhs._buffer;
+				rhs._owner = nullptr;
+			}
+			return *this;
+		}
+
+		explicit operator bool() const noexcept { return valid(); }
+
+		bool valid() const noexcept { return (_owner != nullptr); }
+
+		// An empty frame answers nullptr or 0.
+		SDL_Surface *get() const noexcept { return valid() ? buffer().target.get() : nullptr; }
+
+		const void *pixels() const noexcept { return valid() ? get()->pixels : nullptr; }
+
+		int w() const noexcept { return valid() ? get()->w : 0; }
+
+		int h() const noexcept { return valid() ? get()->h : 0; }
+
+		int pitch() const noexcept { return valid() ? get()->pitch : 0; }
+
+		Uint32 format() const noexcept { return valid() ? get()->format->format : SDL_PIXELFORMAT_UNKNOWN; }
+
+		Uint64 index() const noexcept { return valid() ? buffer().index : 0; }
+
+		void release() noexcept {
+			if (_owner == nullptr) return;
+
+			_owner->release(_buffer);
+			_owner = nullptr;
+		}
+
+	private:
+		friend class offscreen_target;
+
+		frame(offscreen_target *owner, std::size_t buffer) noexcept : _owner(owner), _buffer(buffer) {}
+
+		const offscreen_target::buffer &buffer() const noexcept { return *_owner->_buffers[_buffer]; }
+
+		offscreen_target *_owner = nullptr;
+		std::size_t _buffer = 0;
+	};
+
+	struct statistics {
+		Uint64 frames = 0;
+		Uint64 stalls = 0;
+	};
+
+public:
+	explicit offscreen_target(int width, int height, Uint32 format = SDL_PIXELFORMAT_ARGB8888, std::size_t buffers = 2) {
+		for (std::size_t i = 0; i < std::max<std::size_t>(buffers, 1); ++i) {
+			auto b = std::make_unique<buffer>(width, height, format);
+			if (!b->target.valid() || !b->renderer.valid()) {
+				_buffers.clear();
+				return;
+			}
+			_buffers.push_back(std::move(b));
+		}
+	}
+
+	offscreen_target(const offscreen_target &) = delete;
+
+	offscreen_target &operator =(const offscreen_target &) = delete;
+
+	// Waits for frames held by other threads. Release every frame owned by
+	// the destroying thread first; one still alive there deadlocks.
+	~offscreen_target() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_released.wait(lock, [this] { return (readers() == 0); });
+	}
+
+	bool valid() const noexcept { return !_buffers.empty(); }
+
+	std::size_t buffers() const noexcept { return _buffers.size(); }
+
+	// Returns nullptr when the buffers could not be created.
+	renderer *begin() {
+		if (!valid()) return nullptr;
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_current == none) {
+			if (free_buffer() == none) {
+				++_stats.stalls;
+				_released.wait(lock, [this] { return (free_buffer() != none); });
+			}
+			_current = free_buffer();
+		}
+		return &_buffers[_current]->renderer;
+	}
+
+	frame end() {
+		std::size_t current;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_current == none) return frame();
+
+			current = _current;
+			_current = none;
+		}
+
+		auto &b = *_buffers[current];
+		b.renderer.present();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		b.index = ++_stats.frames;
+		++b.readers;
+		return frame(this, current);
+	}
+
+	statistics stats() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _stats;
+	}
+
+private:
+	static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+	struct buffer {
+		buffer(int width, int height, Uint32 format)
+			: target(0, width, height, SDL_BITSPERPIXEL(format), format), renderer(target.get()) {}
+
+		surface target;
+		sdl::video::renderer renderer;
+		Uint64 index = 0;
+		std::size_t readers = 0;
+	};
+
+	std::size_t free_buffer() const noexcept {
+		auto result = none;
+		for (std::size_t i = 0; i < _buffers.size(); ++i) {
+			auto &b = *_buffers[i];
+			if (b.readers != 0) continue;
+			if ((result == none) || (b.index < _buffers[result]->index)) result = i;
+		}
+		return result;
+	}
+
+	std::size_t readers() const noexcept {
+		std::size_t result = 0;
+		for (auto &b : _buffers) result += b->readers;
+		return result;
+	}
+
+	void release(std::size_t index) noexcept {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_buffers[index]->readers;
+		}
+		_released.notify_all();
+	}
+
+private:
+	std::vector<std::unique_ptr<buffer>> _buffers;
+	std::size_t _current = none;
+	mutable std::mutex _mutex;
+	std::condition_variable _released;
+	statistics _stats;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_OFFSCREEN_TARGET_HPP_
@@ -26,16 +26,16 @@
 
 namespace sdl { inline namespace video {
 
-class palette final : public sdl::detail::resource<SDL_Palette, decltype(&SDL_FreePalette)> {
+class palette final : public sdl::detail::static_resource<SDL_Palette, SDL_FreePalette> {
 public:
 	static decltype(auto) make_resource(int ncolors) {
-		return resource::make_resource(SDL_AllocPalette, SDL_FreePalette, ncolors);
+		return static_resource::make_resource(SDL_AllocPalette, ncolors);
 	}
 
 public:
 	palette() = default;
 
-	explicit palette(int ncolors) : resource(make_resource(ncolors)) {}
+	explicit palette(int ncolors) : static_resource(make_resource(ncolors)) {}
 
 	auto ncolors() const noexcept { return (valid() ? get()->ncolors : 0); }
 
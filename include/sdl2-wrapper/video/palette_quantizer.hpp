@@ -0,0 +1,343 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_PALETTE_QUANTIZER_HPP_
+#define SDL2_WRAPPER_VIDEO_PALETTE_QUANTIZER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class palette_quantizer final {
+public:
+	enum class dither {
+		none,
+		ordered,
+		floyd_steinberg,
+	};
+
+	static constexpr int lut_bits = 5;
+	static constexpr int lut_size = 1 << (3 * lut_bits);
+
+	static std::vector<color> median_cut(const surface &source, int colors, int refine = 2, task_system *tasks = nullptr) {
+		std::vector<color> result;
+		if (!source.valid() || (colors <= 0)) return result;
+
+		surface_lock source_lock(source);
+		if (!source_lock) return result;
+
+		std::vector<bin> histogram(lut_size);
+		std::mutex merge;
+		for_rows(tasks, source.h(), [&](int begin, int end) {
+			std::vector<bin> local(lut_size);
+			std::vector<Uint32> row(static_cast<std::size_t>(source.w()));
+			for (int y = begin; y < end; ++y) {
+				read_row(source, y, row.data());
+				for (auto pixel : row) {
+					auto r = red(pixel), g = green(pixel), b = blue(pixel);
+					auto &entry = local[cell(r, g, b)];
+					++entry.count;
+					entry.r += r;
+					entry.g += g;
+					entry.b += b;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(merge);
+			for (std::size_t i = 0; i < local.size(); ++i) {
+				histogram[i].count += local[i].count;
+				histogram[i].r += local[i].r;
+				histogram[i].g += local[i].g;
+				histogram[i].b += local[i].b;
+			}
+		});
+
+		std::vector<Uint16> cells;
+		for (std::size_t i = 0; i < histogram.size(); ++i) {
+			if (histogram[i].count != 0) cells.push_back(static_cast<Uint16>(i));
+		}
+		if (cells.empty()) return result;
+
+		std::vector<box> boxes;
+		boxes.push_back(make_box(histogram, cells, 0, cells.size()));
+
+		while (static_cast<int>(boxes.size()) < colors) {
+			auto selected = boxes.end();
+			Uint64 best = 0;
+			for (auto it = boxes.begin(); it != boxes.end(); ++it) {
+				auto score = it->population * static_cast<Uint64>(it->extent());
+				if ((it->end - it->begin > 1) && (score > best)) {
+					best = score;
+					selected = it;
+				}
+			}
+			if (selected == boxes.end()) break;
+
+			auto axis = selected->axis();
+			auto first = cells.begin() + selected->begin;
+			auto last = cells.begin() + selected->end;
+			std::sort(first, last, [axis](Uint16 a, Uint16 b) { return coordinate(a, axis) < coordinate(b, axis); });
+
+			Uint64 half = selected->population / 2, accumulated = 0;
+			auto split = selected->begin;
+			while ((split < selected->end - 1) && (accumulated + histogram[cells[split]].count <= half)) {
+				accumulated += histogram[cells[split]].count;
+				++split;
+			}
+			if (split == selected->begin) ++split;
+
+			auto begin = selected->begin, end = selected->end;
+			*selected = make_box(histogram, cells, begin, split);
+			boxes.push_back(make_box(histogram, cells, split, end));
+		}
+
+		for (auto &b : boxes) {
+			Uint64 count = 0, r = 0, g = 0, bl = 0;
+			for (auto i = b.begin; i < b.end; ++i) {
+				auto &entry = histogram[cells[i]];
+				count += entry.count;
+				r += entry.r;
+				g += entry.g;
+				bl += entry.b;
+			}
+			result.emplace_back(static_cast<Uint8>(r / count), static_cast<Uint8>(g / count), static_cast<Uint8>(bl / count));
+		}
+
+		for (int iteration = 0; iteration < refine; ++iteration) {
+			std::vector<bin> sums(result.size());
+			for (auto i : cells) {
+				auto &entry = histogram[i];
+				auto index = nearest(result, static_cast<int>(entry.r / entry.count), static_cast<int>(entry.g / entry.count), static_cast<int>(entry.b / entry.count));
+				sums[index].count += entry.count;
+				sums[index].r += entry.r;
+				sums[index].g += entry.g;
+				sums[index].b += entry.b;
+			}
+			for (std::size_t i = 0; i < result.size(); ++i) {
+				if (sums[i].count == 0) continue;
+				result[i] = color(static_cast<Uint8>(sums[i].r / sums[i].count), static_cast<Uint8>(sums[i].g / sums[i].count), static_cast<Uint8>(sums[i].b / sums[i].count));
+			}
+		}
+
+		return result;
+	}
+
+	static bool quantize(const surface &source, int colors, surface &target, dither mode = dither::none, task_system *tasks = nullptr) {
+		return palette_quantizer(median_cut(source, std::min(colors, 256), 2, tasks), tasks).quantize(source, target, mode);
+	}
+
+public:
+	explicit palette_quantizer(std::vector<color> colors, task_system *tasks = nullptr)
+		: _colors(std::move(colors)), _tasks(tasks), _lut(lut_size) {
+		if (_colors.size() > 256) _colors.resize(256);
+		if (_colors.empty()) return;
+
+		for_rows(_tasks, lut_size, [this](int begin, int end) {
+			for (int i = begin; i < end; ++i) {
+				auto center = [](int c) { return (c << (8 - lut_bits)) + (1 << (7 - lut_bits)); };
+				auto r = center((i >> (2 * lut_bits)) & ((1 << lut_bits) - 1));
+				auto g = center((i >> lut_bits) & ((1 << lut_bits) - 1));
+				auto b = center(i & ((1 << lut_bits) - 1));
+				_lut[static_cast<std::size_t>(i)] = static_cast<Uint8>(nearest(_colors, r, g, b));
+			}
+		});
+	}
+
+	const std::vector<color> &colors() const noexcept { return _colors; }
+
+	Uint8 index(Uint8 r, Uint8 g, Uint8 b) const noexcept { return _lut[cell(r, g, b)]; }
+
+	Uint8 index_exact(Uint8 r, Uint8 g, Uint8 b) const noexcept { return static_cast<Uint8>(nearest(_colors, r, g, b)); }
+
+	bool quantize(const surface &source, surface &target, dither mode = dither::none) const {
+		if (!source.valid() || _colors.empty()) return false;
+
+		target.create_with_format(0, source.w(), source.h(), 8, SDL_PIXELFORMAT_INDEX8);
+		return target.valid() && remap(source, target, mode);
+	}
+
+	bool remap(const surface &source, surface &target, dither mode = dither::none) const {
+		if (!source.valid() || !target.valid() || _colors.empty()) return false;
+
+		if ((target.format()->format != SDL_PIXELFORMAT_INDEX8) || (target.w() != source.w()) || (target.h() != source.h())) {
+			SDL_SetError("palette_quantizer: target must be an INDEX8 surface of the source size");
+			return false;
+		}
+		if (SDL_SetPaletteColors(target.format()->palette, _colors.data(), 0, static_cast<int>(_colors.size())) != 0) return false;
+
+		surface_lock source_lock(source), target_lock(target);
+		if (!source_lock || !target_lock) return false;
+
+		if (mode == dither::floyd_steinberg) {
+			diffuse(source, target);
+			return true;
+		}
+
+		for_rows(_tasks, source.h(), [&](int begin, int end) {
+			std::vector<Uint32> row(static_cast<std::size_t>(source.w()));
+			for (int y = begin; y < end; ++y) {
+				read_row(source, y, row.data());
+				auto out = static_cast<Uint8 *>(target.pixels()) + y * target.pitch();
+				for (int x = 0; x < source.w(); ++x) {
+					int r = red(row[x]), g = green(row[x]), b = blue(row[x]);
+					if (mode == dither::ordered) {
+						static const int bayer[4][4] = { { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 } };
+						auto offset = bayer[y & 3][x & 3] - 8;
+						r = clamp(r + offset);
+						g = clamp(g + offset);
+						b = clamp(b + offset);
+					}
+					out[x] = _lut[cell(r, g, b)];
+				}
+			}
+		});
+		return true;
+	}
+
+private:
+	struct bin {
+		Uint64 count = 0;
+		Uint64 r = 0;
+		Uint64 g = 0;
+		Uint64 b = 0;
+	};
+
+	struct box {
+		std::size_t begin;
+		std::size_t end;
+		Uint64 population;
+		std::array<int, 3> low;
+		std::array<int, 3> high;
+
+		int axis() const noexcept {
+			int result = 0;
+			for (int i = 1; i < 3; ++i) {
+				if (high[i] - low[i] > high[result] - low[result]) result = i;
+			}
+			return result;
+		}
+
+		int extent() const noexcept { return high[axis()] - low[axis()]; }
+	};
+
+	static int red(Uint32 pixel) noexcept { return (pixel >> 16) & 0xff; }
+	static int green(Uint32 pixel) noexcept { return (pixel >> 8) & 0xff; }
+	static int blue(Uint32 pixel) noexcept { return pixel & 0xff; }
+
+	static int clamp(int value) noexcept { return std::min(255, std::max(0, value)); }
+
+	static std::size_t cell(int r, int g, int b) noexcept {
+		return (static_cast<std::size_t>(r >> (8 - lut_bits)) << (2 * lut_bits)) |
+			(static_cast<std::size_t>(g >> (8 - lut_bits)) << lut_bits) |
+			static_cast<std::size_t>(b >> (8 - lut_bits));
+	}
+
+	static int coordinate(Uint16 index, int axis) noexcept { return (index >> ((2 - axis) * lut_bits)) & ((1 << lut_bits) - 1); }
+
+	static box make_box(const std::vector<bin> &histogram, const std::vector<Uint16> &cells, std::size_t begin, std::size_t end) {
+		box result { begin, end, 0, {{ 255, 255, 255 }}, {{ 0, 0, 0 }} };
+		for (auto i = begin; i < end; ++i) {
+			result.population += histogram[cells[i]].count;
+			for (int axis = 0; axis < 3; ++axis) {
+				result.low[axis] = std::min(result.low[axis], coordinate(cells[i], axis));
+				result.high[axis] = std::max(result.high[axis], coordinate(cells[i], axis));
+			}
+		}
+		return result;
+	}
+
+	static std::size_t nearest(const std::vector<color> &colors, int r, int g, int b) noexcept {
+		std::size_t result = 0;
+		auto best = std::numeric_limits<int>::max();
+		for (std::size_t i = 0; i < colors.size(); ++i) {
+			auto dr = r - colors[i].r, dg = g - colors[i].g, db = b - colors[i].b;
+			auto distance = dr * dr + dg * dg + db * db;
+			if (distance < best) {
+				best = distance;
+				result = i;
+			}
+		}
+		return result;
+	}
+
+	static void read_row(const surface &source, int y, Uint32 *row) noexcept {
+		auto in = static_cast<const Uint8 *>(source.pixels()) + y * source.pitch();
+		convert_pixels(source.w(), 1, source.format()->format, in, source.pitch(), SDL_PIXELFORMAT_ARGB8888, row, source.w() * 4);
+	}
+
+	template <typename Function>
+	static void for_rows(task_system *tasks, int count, Function &&fn) {
+		if (tasks != nullptr) {
+			tasks->parallel_for(0, count, std::forward<Function>(fn));
+		} else {
+			fn(0, count);
+		}
+	}
+
+	void diffuse(const surface &source, surface &target) const {
+		auto width = source.w();
+		std::vector<Uint32> row(static_cast<std::size_t>(width));
+		std::vector<int> current(static_cast<std::size_t>(width + 2) * 3), next(current.size());
+
+		for (int y = 0; y < source.h(); ++y) {
+			read_row(source, y, row.data());
+			std::fill(next.begin(), next.end(), 0);
+
+			auto out = static_cast<Uint8 *>(target.pixels()) + y * target.pitch();
+			auto forward = ((y & 1) == 0);
+			for (int i = 0; i < width; ++i) {
+				auto x = forward ? i : width - 1 - i;
+				auto step = forward ? 1 : -1;
+				auto e = static_cast<std::size_t>(x + 1) * 3;
+
+				int value[3] = {
+					clamp(red(row[x]) + current[e] / 16),
+					clamp(green(row[x]) + current[e + 1] / 16),
+					clamp(blue(row[x]) + current[e + 2] / 16),
+				};
+				auto index = _lut[cell(value[0], value[1], value[2])];
+				out[x] = index;
+
+				int error[3] = { value[0] - _colors[index].r, value[1] - _colors[index].g, value[2] - _colors[index].b };
+				for (int c = 0; c < 3; ++c) {
+					current[e + step * 3 + c] += error[c] * 7;
+					next[e - step * 3 + c] += error[c] * 3;
+					next[e + c] += error[c] * 5;
+					next[e + step * 3 + c] += error[c];
+				}
+			}
+			std::swap(current, next);
+		}
+	}
+
+private:
+	std::vector<color> _colors;
+	task_system *_tasks;
+	std::vector<Uint8> _lut;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_PALETTE_QUANTIZER_HPP_
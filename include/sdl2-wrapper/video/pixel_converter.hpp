@@ -0,0 +1,355 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_PIXEL_CONVERTER_HPP_
+#define SDL2_WRAPPER_VIDEO_PIXEL_CONVERTER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class pixel_converter final {
+public:
+	enum class method {
+		fallback,
+		copy,
+		shuffle,
+		lookup,
+	};
+
+	static std::shared_ptr<const pixel_format> shared_format(Uint32 format) {
+		auto &r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+
+		auto &entry = r.formats[format];
+		if (!entry) {
+			auto created = std::make_shared<pixel_format>(format);
+			if (!created->valid()) return nullptr;
+			entry = std::move(created);
+		}
+		return entry;
+	}
+
+	static std::shared_ptr<const pixel_converter> find(Uint32 src_format, Uint32 dst_format) {
+		thread_local std::shared_ptr<const pixel_converter> last;
+		thread_local Uint64 last_generation = 0;
+
+		auto &r = registry();
+		if (last && (last->_src_format == src_format) && (last->_dst_format == dst_format) &&
+			(last_generation == r.generation.load(std::memory_order_acquire))) {
+			return last;
+		}
+
+		auto key = (static_cast<Uint64>(src_format) << 32) | dst_format;
+		{
+			std::lock_guard<std::mutex> lock(r.mutex);
+			auto it = r.converters.find(key);
+			if (it != r.converters.end()) {
+				last = it->second;
+				last_generation = r.generation.load(std::memory_order_relaxed);
+				return last;
+			}
+		}
+
+		auto created = std::make_shared<const pixel_converter>(src_format, dst_format);
+
+		std::lock_guard<std::mutex> lock(r.mutex);
+		auto &entry = r.converters[key];
+		if (!entry) entry = std::move(created);
+
+		last = entry;
+		last_generation = r.generation.load(std::memory_order_relaxed);
+		return entry;
+	}
+
+	static void clear_cache() {
+		auto &r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.converters.clear();
+		r.formats.clear();
+		r.generation.fetch_add(1, std::memory_order_release);
+	}
+
+public:
+	pixel_converter(Uint32 src_format, Uint32 dst_format) : _src_format(src_format), _dst_format(dst_format) {
+		if (!packed(src_format) || !packed(dst_format)) return;
+
+		_src = shared_format(src_format);
+		_dst = shared_format(dst_format);
+		if (!_src || !_dst) return;
+
+		_src_bytes = _src->bytes_per_pixel();
+		_dst_bytes = _dst->bytes_per_pixel();
+
+		if (src_format == dst_format) {
+			_method = method::copy;
+		} else if (build_shuffle()) {
+			_method = method::shuffle;
+		} else {
+			build_lookup();
+			_method = method::lookup;
+		}
+	}
+
+	Uint32 src_format() const noexcept { return _src_format; }
+
+	Uint32 dst_format() const noexcept { return _dst_format; }
+
+	method conversion() const noexcept { return _method; }
+
+	bool convert(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch) const noexcept {
+		if ((width <= 0) || (height <= 0)) return true;
+
+		auto s = static_cast<const Uint8 *>(src);
+		auto d = static_cast<Uint8 *>(dst);
+
+		switch (_method) {
+		case method::copy:
+			for (int y = 0; y < height; ++y) {
+				std::memmove(d + y * dst_pitch, s + y * src_pitch, static_cast<std::size_t>(width) * _src_bytes);
+			}
+			return true;
+
+		case method::shuffle:
+			for (int y = 0; y < height; ++y) {
+				auto in = s + y * src_pitch;
+				auto out = d + y * dst_pitch;
+				for (int x = 0; x < width; ++x, in += 4, out += 4) {
+					for (int i = 0; i < 4; ++i) out[i] = (_shuffle[i] >= 0) ? in[_shuffle[i]] : (_shuffle[i] == opaque) ? 0xff : 0;
+				}
+			}
+			return true;
+
+		case method::lookup:
+			dispatch(width, height, s, src_pitch, d, dst_pitch);
+			return true;
+
+		default:
+			return (SDL_ConvertPixels(width, height, _src_format, src, src_pitch, _dst_format, dst, dst_pitch) == 0);
+		}
+	}
+
+private:
+	struct channel {
+		Uint32 mask = 0;
+		int shift = 0;
+		int bits = 0;
+	};
+
+	struct registry_type {
+		std::mutex mutex;
+		std::unordered_map<Uint32, std::shared_ptr<const pixel_format>> formats;
+		std::unordered_map<Uint64, std::shared_ptr<const pixel_converter>> converters;
+		std::atomic<Uint64> generation { 1 };
+	};
+
+	static registry_type &registry() {
+		static registry_type instance;
+		return instance;
+	}
+
+	static bool packed(Uint32 format) noexcept {
+		return (format != SDL_PIXELFORMAT_UNKNOWN) && !SDL_ISPIXELFORMAT_FOURCC(format) && !SDL_ISPIXELFORMAT_INDEXED(format) &&
+			(SDL_BYTESPERPIXEL(format) >= 1) && (SDL_BYTESPERPIXEL(format) <= 4);
+	}
+
+	static channel make_channel(Uint32 mask) noexcept {
+		channel result;
+		result.mask = mask;
+		if (mask == 0) return result;
+
+		while (((mask >> result.shift) & 1) == 0) ++result.shift;
+		for (auto m = mask >> result.shift; (m & 1) != 0; m >>= 1) ++result.bits;
+		return result;
+	}
+
+	static std::array<channel, 4> channels(const pixel_format &format) noexcept {
+		return {{ make_channel(format.r_mask()), make_channel(format.g_mask()), make_channel(format.b_mask()), make_channel(format.a_mask()) }};
+	}
+
+	// Like SDL's blitters, channels go through 8 bits: narrower ones are
+	// widened by bit replication, and narrowing truncates.
+	static Uint32 expand(Uint32 value, int bits) noexcept {
+		if (bits >= 8) return (value >> (bits - 8)) & 0xff;
+
+		auto result = value << (8 - bits);
+		for (auto filled = bits; filled < 8; filled *= 2) result |= result >> filled;
+		return result & 0xff;
+	}
+
+	static Uint32 narrow(Uint32 value, int bits) noexcept {
+		return (bits <= 8) ? (value >> (8 - bits)) : ((value << (bits - 8)) | (value >> (16 - bits)));
+	}
+
+	static int byte_index(const channel &c, int bytes) noexcept {
+		if ((c.bits != 8) || ((c.shift % 8) != 0)) return -1;
+		return sdl::is_big_endian ? (bytes - 1 - c.shift / 8) : (c.shift / 8);
+	}
+
+	bool build_shuffle() noexcept {
+		if ((_src_bytes != 4) || (_dst_bytes != 4)) return false;
+
+		auto src = channels(*_src);
+		auto dst = channels(*_dst);
+
+		_shuffle.fill(padding);
+		int covered = 0;
+		for (int c = 0; c < 4; ++c) {
+			if (dst[c].mask == 0) continue;
+
+			auto to = byte_index(dst[c], 4);
+			if (to < 0) return false;
+			covered |= 1 << to;
+
+			if (src[c].mask == 0) {
+				if (c != 3) return false;
+				_shuffle[to] = opaque;
+				continue;
+			}
+
+			auto from = byte_index(src[c], 4);
+			if (from < 0) return false;
+			_shuffle[to] = static_cast<Sint8>(from);
+		}
+
+		return (covered == 0xf) || (_dst->a_mask() == 0);
+	}
+
+	void build_lookup() {
+		auto src = channels(*_src);
+		auto dst = channels(*_dst);
+
+		_fill = 0;
+		for (int c = 0; c < 4; ++c) {
+			_shift[c] = src[c].shift;
+			_mask[c] = (src[c].bits > 0) ? ((1u << src[c].bits) - 1) : 0;
+
+			if (dst[c].mask == 0) {
+				_mask[c] = 0;
+				continue;
+			}
+			if (src[c].mask == 0) {
+				if (c == 3) _fill |= dst[c].mask;
+				continue;
+			}
+
+			auto src_max = (1u << src[c].bits) - 1;
+			_lut[c].resize(src_max + 1);
+			for (Uint32 v = 0; v <= src_max; ++v) {
+				_lut[c][v] = narrow(expand(v, src[c].bits), dst[c].bits) << dst[c].shift;
+			}
+		}
+	}
+
+	template <int Bytes>
+	static Uint32 load(const Uint8 *p) noexcept {
+		switch (Bytes) {
+		case 1: return p[0];
+		case 2: { Uint16 v; std::memcpy(&v, p, 2); return v; }
+		case 3: return sdl::is_big_endian ? ((Uint32(p[0]) << 16) | (Uint32(p[1]) << 8) | p[2]) : (p[0] | (Uint32(p[1]) << 8) | (Uint32(p[2]) << 16));
+		default: { Uint32 v; std::memcpy(&v, p, 4); return v; }
+		}
+	}
+
+	template <int Bytes>
+	static void store(Uint8 *p, Uint32 v) noexcept {
+		switch (Bytes) {
+		case 1: p[0] = static_cast<Uint8>(v); break;
+		case 2: { auto w = static_cast<Uint16>(v); std::memcpy(p, &w, 2); break; }
+		case 3:
+			if (sdl::is_big_endian) {
+				p[0] = static_cast<Uint8>(v >> 16); p[1] = static_cast<Uint8>(v >> 8); p[2] = static_cast<Uint8>(v);
+			} else {
+				p[0] = static_cast<Uint8>(v); p[1] = static_cast<Uint8>(v >> 8); p[2] = static_cast<Uint8>(v >> 16);
+			}
+			break;
+		default: std::memcpy(p, &v, 4); break;
+		}
+	}
+
+	Uint32 translate(Uint32 pixel) const noexcept {
+		auto result = _fill;
+		for (int c = 0; c < 4; ++c) {
+			if (_mask[c] != 0) result |= _lut[c][(pixel >> _shift[c]) & _mask[c]];
+		}
+		return result;
+	}
+
+	template <int Src, int Dst>
+	void run(int width, int height, const Uint8 *src, int src_pitch, Uint8 *dst, int dst_pitch) const noexcept {
+		for (int y = 0; y < height; ++y) {
+			auto in = src + y * src_pitch;
+			auto out = dst + y * dst_pitch;
+			for (int x = 0; x < width; ++x, in += Src, out += Dst) {
+				store<Dst>(out, translate(load<Src>(in)));
+			}
+		}
+	}
+
+	template <int Src>
+	void dispatch_dst(int width, int height, const Uint8 *src, int src_pitch, Uint8 *dst, int dst_pitch) const noexcept {
+		switch (_dst_bytes) {
+		case 1: run<Src, 1>(width, height, src, src_pitch, dst, dst_pitch); break;
+		case 2: run<Src, 2>(width, height, src, src_pitch, dst, dst_pitch); break;
+		case 3: run<Src, 3>(width, height, src, src_pitch, dst, dst_pitch); break;
+		default: run<Src, 4>(width, height, src, src_pitch, dst, dst_pitch); break;
+		}
+	}
+
+	void dispatch(int width, int height, const Uint8 *src, int src_pitch, Uint8 *dst, int dst_pitch) const noexcept {
+		switch (_src_bytes) {
+		case 1: dispatch_dst<1>(width, height, src, src_pitch, dst, dst_pitch); break;
+		case 2: dispatch_dst<2>(width, height, src, src_pitch, dst, dst_pitch); break;
+		case 3: dispatch_dst<3>(width, height, src, src_pitch, dst, dst_pitch); break;
+		default: dispatch_dst<4>(width, height, src, src_pitch, dst, dst_pitch); break;
+		}
+	}
+
+private:
+	// Shuffle entries for destination bytes with no source byte.
+	enum : Sint8 { padding = -1, opaque = -2 };
+
+	Uint32 _src_format;
+	Uint32 _dst_format;
+	method _method = method::fallback;
+
+	std::shared_ptr<const pixel_format> _src;
+	std::shared_ptr<const pixel_format> _dst;
+	int _src_bytes = 0;
+	int _dst_bytes = 0;
+
+	std::array<Sint8, 4> _shuffle {{ padding, padding, padding, padding }};
+
+	std::array<std::vector<Uint32>, 4> _lut;
+	std::array<int, 4> _shift {{ 0, 0, 0, 0 }};
+	std::array<Uint32, 4> _mask {{ 0, 0, 0, 0 }};
+	Uint32 _fill = 0;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_PIXEL_CONVERTER_HPP_
@@ -28,7 +28,7 @@ namespace sdl { inline namespace video {
 
 void calculate_gamma_ramp(float gamma, Uint16 *ramp) noexcept { SDL_CalculateGammaRamp(gamma, ramp); }
 
-class pixel_format final : public sdl::detail::resource<SDL_PixelFormat, decltype(&SDL_FreeFormat)> {
+class pixel_format final : public sdl::detail::static_resource<SDL_PixelFormat, SDL_FreeFormat> {
 public:
 	static auto enum_name(Uint32 format) noexcept { return SDL_GetPixelFormatName(format); }
 
@@ -41,7 +41,7 @@ public:
 	}
 
 	static decltype(auto) make_resource(Uint32 format) {
-		return resource::make_resource(SDL_AllocFormat, SDL_FreeFormat, format);
+		return static_resource::make_resource(SDL_AllocFormat, format);
 	}
 
 public:
@@ -50,7 +50,7 @@ public:
 	pixel_format() = default;
 
 	explicit pixel_format(Uint32 format)
-		: resource(make_resource(format)) {}
+		: static_resource(make_resource(format)) {}
 
 	void create(Uint32 format) {
 		_handle_holder = make_resource(format);
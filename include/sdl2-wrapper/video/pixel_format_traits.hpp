@@ -0,0 +1,221 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_PIXEL_FORMAT_TRAITS_HPP_
+#define SDL2_WRAPPER_VIDEO_PIXEL_FORMAT_TRAITS_HPP_
+
+#include <cstring>
+#include <type_traits>
+
+namespace sdl { namespace detail {
+
+struct channel_layout {
+	Uint32 mask;
+	int shift;
+	int bits;
+};
+
+constexpr int packed_width(Uint32 layout, int component) noexcept {
+	switch (layout) {
+	case SDL_PACKEDLAYOUT_332: return (component == 0) ? 0 : (component == 3) ? 2 : 3;
+	case SDL_PACKEDLAYOUT_4444: return 4;
+	case SDL_PACKEDLAYOUT_1555: return (component == 0) ? 1 : 5;
+	case SDL_PACKEDLAYOUT_5551: return (component == 3) ? 1 : 5;
+	case SDL_PACKEDLAYOUT_565: return (component == 0) ? 0 : (component == 2) ? 6 : 5;
+	case SDL_PACKEDLAYOUT_8888: return 8;
+	case SDL_PACKEDLAYOUT_2101010: return (component == 0) ? 2 : 10;
+	case SDL_PACKEDLAYOUT_1010102: return (component == 3) ? 2 : 10;
+	default: return 0;
+	}
+}
+
+constexpr char packed_component(Uint32 order, int component) noexcept {
+	switch (order) {
+	case SDL_PACKEDORDER_XRGB: return "XRGB"[component];
+	case SDL_PACKEDORDER_RGBX: return "RGBX"[component];
+	case SDL_PACKEDORDER_ARGB: return "ARGB"[component];
+	case SDL_PACKEDORDER_RGBA: return "RGBA"[component];
+	case SDL_PACKEDORDER_XBGR: return "XBGR"[component];
+	case SDL_PACKEDORDER_BGRX: return "BGRX"[component];
+	case SDL_PACKEDORDER_ABGR: return "ABGR"[component];
+	case SDL_PACKEDORDER_BGRA: return "BGRA"[component];
+	default: return 'X';
+	}
+}
+
+constexpr char array_component(Uint32 order, int component) noexcept {
+	switch (order) {
+	case SDL_ARRAYORDER_RGB: return "RGB"[component];
+	case SDL_ARRAYORDER_RGBA: return "RGBA"[component];
+	case SDL_ARRAYORDER_ARGB: return "ARGB"[component];
+	case SDL_ARRAYORDER_BGR: return "BGR"[component];
+	case SDL_ARRAYORDER_BGRA: return "BGRA"[component];
+	case SDL_ARRAYORDER_ABGR: return "ABGR"[component];
+	default: return 'X';
+	}
+}
+
+constexpr bool is_packed_type(Uint32 format) noexcept {
+	return !SDL_ISPIXELFORMAT_FOURCC(format) &&
+		((SDL_PIXELTYPE(format) == SDL_PIXELTYPE_PACKED8) || (SDL_PIXELTYPE(format) == SDL_PIXELTYPE_PACKED16) || (SDL_PIXELTYPE(format) == SDL_PIXELTYPE_PACKED32));
+}
+
+constexpr bool is_byte_array_type(Uint32 format) noexcept {
+	return !SDL_ISPIXELFORMAT_FOURCC(format) && (SDL_PIXELTYPE(format) == SDL_PIXELTYPE_ARRAYU8);
+}
+
+constexpr channel_layout channel_of(Uint32 format, char name) noexcept {
+	if (is_packed_type(format)) {
+		int shift = 0;
+		for (int component = 0; component < 4; ++component) shift += packed_width(SDL_PIXELLAYOUT(format), component);
+
+		for (int component = 0; component < 4; ++component) {
+			auto bits = packed_width(SDL_PIXELLAYOUT(format), component);
+			shift -= bits;
+			if ((bits > 0) && (packed_component(SDL_PIXELORDER(format), component) == name)) {
+				return { ((Uint32(1) << bits) - 1) << shift, shift, bits };
+			}
+		}
+	} else if (is_byte_array_type(format)) {
+		auto count = static_cast<int>(SDL_BYTESPERPIXEL(format));
+		for (int component = 0; component < count; ++component) {
+			if (array_component(SDL_PIXELORDER(format), component) == name) {
+				auto shift = (SDL_BYTEORDER == SDL_BIG_ENDIAN) ? 8 * (count - 1 - component) : 8 * component;
+				return { Uint32(0xff) << shift, shift, 8 };
+			}
+		}
+	}
+	return { 0, 0, 0 };
+}
+
+} } // namespace sdl::detail
+
+namespace sdl { inline namespace video {
+
+template <Uint32 Format>
+struct pixel_format_traits final {
+	static_assert(detail::is_packed_type(Format) || detail::is_byte_array_type(Format), "pixel_format_traits supports packed and 8-bit array formats");
+
+	using pixel_type = std::conditional_t<(SDL_BYTESPERPIXEL(Format) == 1), Uint8, std::conditional_t<(SDL_BYTESPERPIXEL(Format) == 2), Uint16, Uint32>>;
+
+	static constexpr Uint32 format = Format;
+	static constexpr int bits_per_pixel = SDL_BITSPERPIXEL(Format);
+	static constexpr int bytes_per_pixel = SDL_BYTESPERPIXEL(Format);
+
+	static constexpr Uint32 r_mask = detail::channel_of(Format, 'R').mask;
+	static constexpr Uint32 g_mask = detail::channel_of(Format, 'G').mask;
+	static constexpr Uint32 b_mask = detail::channel_of(Format, 'B').mask;
+	static constexpr Uint32 a_mask = detail::channel_of(Format, 'A').mask;
+
+	static constexpr int r_shift = detail::channel_of(Format, 'R').shift;
+	static constexpr int g_shift = detail::channel_of(Format, 'G').shift;
+	static constexpr int b_shift = detail::channel_of(Format, 'B').shift;
+	static constexpr int a_shift = detail::channel_of(Format, 'A').shift;
+
+	static constexpr int r_bits = detail::channel_of(Format, 'R').bits;
+	static constexpr int g_bits = detail::channel_of(Format, 'G').bits;
+	static constexpr int b_bits = detail::channel_of(Format, 'B').bits;
+	static constexpr int a_bits = detail::channel_of(Format, 'A').bits;
+
+	static constexpr bool has_alpha = (a_bits != 0);
+
+	static constexpr Uint32 map(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 0xff) noexcept {
+		return pack(r, r_bits, r_shift) | pack(g, g_bits, g_shift) | pack(b, b_bits, b_shift) | pack(a, a_bits, a_shift);
+	}
+
+	static constexpr Uint32 map(const color &c) noexcept { return map(c.r, c.g, c.b, c.a); }
+
+	static constexpr color unmap(Uint32 pixel) noexcept {
+		return {
+			unpack(pixel, r_bits, r_shift, 0),
+			unpack(pixel, g_bits, g_shift, 0),
+			unpack(pixel, b_bits, b_shift, 0),
+			unpack(pixel, a_bits, a_shift, 0xff)
+		};
+	}
+
+	static Uint32 load(const void *p) noexcept {
+		auto bytes = static_cast<const Uint8 *>(p);
+		switch (bytes_per_pixel) {
+		case 1: return bytes[0];
+		case 2: { Uint16 v; std::memcpy(&v, bytes, 2); return v; }
+		case 3:
+			return (SDL_BYTEORDER == SDL_BIG_ENDIAN) ?
+				((Uint32(bytes[0]) << 16) | (Uint32(bytes[1]) << 8) | bytes[2]) :
+				(bytes[0] | (Uint32(bytes[1]) << 8) | (Uint32(bytes[2]) << 16));
+		default: { Uint32 v; std::memcpy(&v, bytes, 4); return v; }
+		}
+	}
+
+	static void store(void *p, Uint32 pixel) noexcept {
+		auto bytes = static_cast<Uint8 *>(p);
+		switch (bytes_per_pixel) {
+		case 1: bytes[0] = static_cast<Uint8>(pixel); break;
+		case 2: { auto v = static_cast<Uint16>(pixel); std::memcpy(bytes, &v, 2); break; }
+		case 3:
+			if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
+				bytes[0] = static_cast<Uint8>(pixel >> 16); bytes[1] = static_cast<Uint8>(pixel >> 8); bytes[2] = static_cast<Uint8>(pixel);
+			} else {
+				bytes[0] = static_cast<Uint8>(pixel); bytes[1] = static_cast<Uint8>(pixel >> 8); bytes[2] = static_cast<Uint8>(pixel >> 16);
+			}
+			break;
+		default: std::memcpy(bytes, &pixel, 4); break;
+		}
+	}
+
+private:
+	static constexpr Uint32 pack(Uint8 value, int bits, int shift) noexcept {
+		return (bits == 0) ? 0 :
+			(bits <= 8) ? (Uint32(value >> (8 - bits)) << shift) :
+			(((Uint32(value) << (bits - 8)) | (Uint32(value) >> (16 - bits))) << shift);
+	}
+
+	static constexpr Uint8 unpack(Uint32 pixel, int bits, int shift, Uint8 missing) noexcept {
+		return (bits == 0) ? missing :
+			(bits >= 8) ? static_cast<Uint8>((pixel >> (shift + bits - 8)) & 0xff) :
+			replicate(static_cast<Uint8>(((pixel >> shift) & ((1u << bits) - 1)) << (8 - bits)), bits);
+	}
+
+	static constexpr Uint8 replicate(Uint8 value, int bits) noexcept {
+		return (bits >= 8) ? value : replicate(static_cast<Uint8>(value | (value >> bits)), bits * 2);
+	}
+};
+
+template <Uint32 Format> constexpr Uint32 pixel_format_traits<Format>::format;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::bits_per_pixel;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::bytes_per_pixel;
+template <Uint32 Format> constexpr Uint32 pixel_format_traits<Format>::r_mask;
+template <Uint32 Format> constexpr Uint32 pixel_format_traits<Format>::g_mask;
+template <Uint32 Format> constexpr Uint32 pixel_format_traits<Format>::b_mask;
+template <Uint32 Format> constexpr Uint32 pixel_format_traits<Format>::a_mask;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::r_shift;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::g_shift;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::b_shift;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::a_shift;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::r_bits;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::g_bits;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::b_bits;
+template <Uint32 Format> constexpr int pixel_format_traits<Format>::a_bits;
+template <Uint32 Format> constexpr bool pixel_format_traits<Format>::has_alpha;
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_PIXEL_FORMAT_TRAITS_HPP_
@@ -24,22 +24,22 @@
 
 namespace sdl { inline namespace video {
 
-class renderer final : public sdl::detail::resource<SDL_Renderer, decltype(&SDL_DestroyRenderer)>
+class renderer final : public sdl::detail::static_resource<SDL_Renderer, SDL_DestroyRenderer>
 {
 public:
 	static decltype(auto) make_resource(SDL_Window* window, int index, Uint32 flags) {
-		return resource::make_resource(SDL_CreateRenderer, SDL_DestroyRenderer, window, index, flags);
+		return static_resource::make_resource(SDL_CreateRenderer, window, index, flags);
 	}
 
 	static decltype(auto) make_resource(SDL_Surface* surface) {
-		return resource::make_resource(SDL_CreateSoftwareRenderer, SDL_DestroyRenderer, surface);
+		return static_resource::make_resource(SDL_CreateSoftwareRenderer, surface);
 	}
 
 	explicit renderer(SDL_Window* window, int index, Uint32 flags)
-		: resource(make_resource(window, index, flags)) {}
+		: static_resource(make_resource(window, index, flags)) {}
 
 	explicit renderer(SDL_Surface* surface)
-		: resource(make_resource(surface)) {}
+		: static_resource(make_resource(surface)) {}
 
 	void create(SDL_Window* window, int index, Uint32 flags) {
 		_handle_holder = make_resource(window, index, flags);
@@ -147,6 +147,21 @@ public:
 		return (SDL_RenderCopyEx(get(), texture, srcrect, dstrect, angle, center, flip) == 0);
 	}
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	bool geometry(SDL_Texture *texture, const SDL_Vertex *vertices, int num_vertices, const int *indices, int num_indices) noexcept {
+		return (SDL_RenderGeometry(get(), texture, vertices, num_vertices, indices, num_indices) == 0);
+	}
+#endif
+
+	static bool geometry_supported() noexcept {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+		static const bool result = (version().value() >= version(2, 0, 18).value());
+		return result;
+#else
+		return false;
+#endif
+	}
+
 	bool read_pixels(const SDL_Rect * rect, Uint32 format, void *pixels, int pitch) const noexcept {
 		return (SDL_RenderReadPixels(get(), rect, format, pixels, pitch) == 0); 
 	}
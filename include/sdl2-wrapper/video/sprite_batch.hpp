@@ -0,0 +1,243 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_SPRITE_BATCH_HPP_
+#define SDL2_WRAPPER_VIDEO_SPRITE_BATCH_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class sprite_batch final {
+public:
+	struct sprite {
+		SDL_Texture *texture = nullptr;
+		rect source;
+		float x = 0.0f;
+		float y = 0.0f;
+		float origin_x = 0.0f;
+		float origin_y = 0.0f;
+		float scale_x = 1.0f;
+		float scale_y = 1.0f;
+		float angle = 0.0f;
+		color tint = color(0xFF, 0xFF, 0xFF);
+		SDL_RendererFlip flip = SDL_FLIP_NONE;
+	};
+
+	struct statistics {
+		std::size_t sprites = 0;
+		std::size_t batches = 0;
+		std::size_t calls = 0;
+	};
+
+public:
+	explicit sprite_batch(renderer &renderer, std::size_t capacity = 1024) : _renderer(renderer) {
+		_sprites.reserve(capacity);
+	}
+
+	sprite_batch(const sprite_batch &) = delete;
+
+	sprite_batch &operator =(const sprite_batch &) = delete;
+
+	void draw(const sprite &s) {
+		if ((s.texture == nullptr) || (s.source.w <= 0) || (s.source.h <= 0)) return;
+		_sprites.push_back(s);
+	}
+
+	void draw(
+		SDL_Texture *texture,
+		const rect &source,
+		float x,
+		float y,
+		float angle = 0.0f,
+		float scale = 1.0f,
+		const color &tint = color(0xFF, 0xFF, 0xFF)
+	) {
+		sprite s;
+		s.texture = texture;
+		s.source = source;
+		s.x = x;
+		s.y = y;
+		s.origin_x = source.w * 0.5f;
+		s.origin_y = source.h * 0.5f;
+		s.scale_x = scale;
+		s.scale_y = scale;
+		s.angle = angle;
+		s.tint = tint;
+		draw(s);
+	}
+
+	std::size_t size() const noexcept { return _sprites.size(); }
+
+	bool empty() const noexcept { return _sprites.empty(); }
+
+	void clear() noexcept { _sprites.clear(); }
+
+	bool geometry() const noexcept { return _geometry; }
+
+	void geometry(bool enable) noexcept { _geometry = enable && renderer::geometry_supported(); }
+
+	bool flush() {
+		_stats = statistics();
+		_stats.sprites = _sprites.size();
+
+		bool result = true;
+		for (std::size_t first = 0; first < _sprites.size(); ) {
+			auto last = first + 1;
+			while ((last < _sprites.size()) && (_sprites[last].texture == _sprites[first].texture)) ++last;
+
+			++_stats.batches;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+			result &= _geometry ? flush_geometry(first, last) : flush_copy(first, last);
+#else
+			result &= flush_copy(first, last);
+#endif
+			first = last;
+		}
+
+		clear();
+		return result;
+	}
+
+	const statistics &stats() const noexcept { return _stats; }
+
+private:
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	bool flush_geometry(std::size_t first, std::size_t last) {
+		auto texture = _sprites[first].texture;
+		int w = 1, h = 1;
+		if (SDL_QueryTexture(texture, nullptr, nullptr, &w, &h) != 0) return false;
+
+		auto sx = 1.0f / static_cast<float>(w);
+		auto sy = 1.0f / static_cast<float>(h);
+
+		_vertices.clear();
+		_indices.clear();
+		_vertices.reserve((last - first) * 4);
+		_indices.reserve((last - first) * 6);
+		for (auto i = first; i < last; ++i) {
+			auto &s = _sprites[i];
+			auto radian = s.angle * 0.017453292519943295f;
+			auto c = std::cos(radian);
+			auto n = std::sin(radian);
+
+			auto left = -s.origin_x * s.scale_x;
+			auto top = -s.origin_y * s.scale_y;
+			auto right = (s.source.w - s.origin_x) * s.scale_x;
+			auto bottom = (s.source.h - s.origin_y) * s.scale_y;
+
+			auto u0 = s.source.x * sx;
+			auto v0 = s.source.y * sy;
+			auto u1 = (s.source.x + s.source.w) * sx;
+			auto v1 = (s.source.y + s.source.h) * sy;
+			if ((s.flip & SDL_FLIP_HORIZONTAL) != 0) std::swap(u0, u1);
+			if ((s.flip & SDL_FLIP_VERTICAL) != 0) std::swap(v0, v1);
+
+			auto base = static_cast<int>(_vertices.size());
+			auto corner = [&](float px, float py, float u, float v) {
+				_vertices.push_back(SDL_Vertex { { s.x + px * c - py * n, s.y + px * n + py * c }, s.tint, { u, v } });
+			};
+			corner(left, top, u0, v0);
+			corner(right, top, u1, v0);
+			corner(right, bottom, u1, v1);
+			corner(left, bottom, u0, v1);
+
+			const int indices[] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+			_indices.insert(_indices.end(), std::begin(indices), std::end(indices));
+		}
+
+		++_stats.calls;
+		return _renderer.geometry(texture, _vertices.data(), static_cast<int>(_vertices.size()), _indices.data(), static_cast<int>(_indices.size()));
+	}
+#endif
+
+	bool flush_copy(std::size_t first, std::size_t last) noexcept {
+		auto texture = _sprites[first].texture;
+		Uint8 r, g, b, a;
+		SDL_GetTextureColorMod(texture, &r, &g, &b);
+		SDL_GetTextureAlphaMod(texture, &a);
+
+		bool result = true;
+		color current(r, g, b, a);
+		for (auto i = first; i < last; ++i) {
+			auto &s = _sprites[i];
+			if (s.tint != current) {
+				current = s.tint;
+				SDL_SetTextureColorMod(texture, current.r, current.g, current.b);
+				SDL_SetTextureAlphaMod(texture, current.a);
+			}
+
+			// A negative scale mirrors around the origin, as the geometry path
+			// does, so turn it into a flip over a positive size.
+			auto flip = static_cast<int>(s.flip);
+			auto scale_x = s.scale_x, scale_y = s.scale_y;
+			auto origin_x = s.origin_x, origin_y = s.origin_y;
+			if (scale_x < 0.0f) {
+				flip ^= SDL_FLIP_HORIZONTAL;
+				scale_x = -scale_x;
+				origin_x = s.source.w - origin_x;
+			}
+			if (scale_y < 0.0f) {
+				flip ^= SDL_FLIP_VERTICAL;
+				scale_y = -scale_y;
+				origin_y = s.source.h - origin_y;
+			}
+
+			rect destination(
+				static_cast<int>(std::lround(s.x - origin_x * scale_x)),
+				static_cast<int>(std::lround(s.y - origin_y * scale_y)),
+				static_cast<int>(std::lround(s.source.w * scale_x)),
+				static_cast<int>(std::lround(s.source.h * scale_y))
+			);
+			SDL_Point center {
+				static_cast<int>(std::lround(origin_x * scale_x)),
+				static_cast<int>(std::lround(origin_y * scale_y))
+			};
+
+			++_stats.calls;
+			if ((s.angle == 0.0f) && (flip == SDL_FLIP_NONE)) {
+				result &= _renderer.copy(texture, &s.source, &destination);
+			} else {
+				result &= _renderer.copy(texture, &s.source, &destination, s.angle, &center, static_cast<SDL_RendererFlip>(flip));
+			}
+		}
+
+		SDL_SetTextureColorMod(texture, r, g, b);
+		SDL_SetTextureAlphaMod(texture, a);
+		return result;
+	}
+
+private:
+	renderer &_renderer;
+	bool _geometry = renderer::geometry_supported();
+	std::vector<sprite> _sprites;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	std::vector<SDL_Vertex> _vertices;
+	std::vector<int> _indices;
+#endif
+	statistics _stats;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_SPRITE_BATCH_HPP_
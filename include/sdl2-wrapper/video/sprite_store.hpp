@@ -0,0 +1,235 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_SPRITE_STORE_HPP_
+#define SDL2_WRAPPER_VIDEO_SPRITE_STORE_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class sprite_store final {
+public:
+	using id_type = std::size_t;
+	using traits = pixel_format_traits<SDL_PIXELFORMAT_ARGB8888>;
+
+	static constexpr id_type invalid_id = static_cast<id_type>(-1);
+
+	enum class run : Uint32 {
+		skip = 0,
+		copy = 1,
+		blend = 2,
+	};
+
+public:
+	sprite_store() = default;
+
+	sprite_store(const sprite_store &) = delete;
+
+	sprite_store &operator =(const sprite_store &) = delete;
+
+	id_type add(const surface &source) {
+		if (!source.valid()) return invalid_id;
+
+		surface_lock source_lock(source);
+		if (!source_lock) return invalid_id;
+
+		sprite s;
+		s.width = source.w();
+		s.height = source.h();
+		s.rows.reserve(static_cast<std::size_t>(s.height) + 1);
+
+		std::vector<Uint32> line(static_cast<std::size_t>(s.width));
+		for (int y = 0; y < s.height; ++y) {
+			auto in = static_cast<const Uint8 *>(source.pixels()) + y * source.pitch();
+			if (!convert_pixels(s.width, 1, source.format()->format, in, source.pitch(), SDL_PIXELFORMAT_ARGB8888, line.data(), s.width * 4)) {
+				return invalid_id;
+			}
+
+			s.rows.push_back(static_cast<Uint32>(s.data.size()));
+			encode_row(line, s.data);
+		}
+		s.rows.push_back(static_cast<Uint32>(s.data.size()));
+		s.data.shrink_to_fit();
+
+		_sprites.push_back(std::move(s));
+		return _sprites.size() - 1;
+	}
+
+	void clear() noexcept {
+		_sprites.clear();
+		_scratch.reset();
+	}
+
+	std::size_t size() const noexcept { return _sprites.size(); }
+
+	bool contains(id_type id) const noexcept { return (id < _sprites.size()); }
+
+	int w(id_type id) const noexcept { return contains(id) ? _sprites[id].width : 0; }
+
+	int h(id_type id) const noexcept { return contains(id) ? _sprites[id].height : 0; }
+
+	std::size_t memory() const noexcept {
+		std::size_t result = 0;
+		for (auto &s : _sprites) result += sizeof(sprite) + (s.data.capacity() + s.rows.capacity()) * sizeof(Uint32);
+		return result;
+	}
+
+	std::size_t raw_memory() const noexcept {
+		std::size_t result = 0;
+		for (auto &s : _sprites) result += sizeof(SDL_Surface) + static_cast<std::size_t>(s.width) * static_cast<std::size_t>(s.height) * 4;
+		return result;
+	}
+
+	bool decode(id_type id, surface &target) const {
+		if (!contains(id)) return false;
+
+		auto &s = _sprites[id];
+		if (!target.valid() || (target.w() != s.width) || (target.h() != s.height) || (target.format()->format != SDL_PIXELFORMAT_ARGB8888)) {
+			target.create_with_format(0, s.width, s.height, 32, SDL_PIXELFORMAT_ARGB8888);
+			if (!target.valid()) return false;
+		}
+
+		surface_lock target_lock(target);
+		if (!target_lock) return false;
+
+		for (int y = 0; y < s.height; ++y) {
+			auto out = reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(target.pixels()) + y * target.pitch());
+			std::fill(out, out + s.width, 0u);
+
+			int x = 0;
+			for (auto p = s.data.data() + s.rows[y], end = s.data.data() + s.rows[y + 1]; p != end;) {
+				auto kind = static_cast<run>(*p >> 24);
+				auto count = static_cast<int>(*p++ & 0xffffff);
+				if (kind != run::skip) {
+					std::memcpy(out + x, p, static_cast<std::size_t>(count) * 4);
+					p += count;
+				}
+				x += count;
+			}
+		}
+		return true;
+	}
+
+	const surface *scratch(id_type id) {
+		if (!_scratch) _scratch = std::make_unique<surface>(0, 1, 1, 32, SDL_PIXELFORMAT_ARGB8888);
+		return decode(id, *_scratch) ? _scratch.get() : nullptr;
+	}
+
+	bool blit(id_type id, surface &target, int x, int y) {
+		if (!contains(id) || !target.valid()) return false;
+
+		if (target.format()->format != SDL_PIXELFORMAT_ARGB8888) {
+			auto source = scratch(id);
+			if (source == nullptr) return false;
+
+			SDL_SetSurfaceBlendMode(source->get(), SDL_BLENDMODE_BLEND);
+			SDL_Rect position { x, y, 0, 0 };
+			return (SDL_BlitSurface(source->get(), nullptr, target.get(), &position) == 0);
+		}
+
+		auto &s = _sprites[id];
+		auto clip = target.clip_rect();
+		auto x0 = std::max(x, clip.x), x1 = std::min(x + s.width, clip.x + clip.w);
+		auto y0 = std::max(y, clip.y), y1 = std::min(y + s.height, clip.y + clip.h);
+		if ((x0 >= x1) || (y0 >= y1)) return true;
+
+		surface_lock target_lock(target);
+		if (!target_lock) return false;
+
+		for (auto row = y0; row < y1; ++row) {
+			auto out = reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(target.pixels()) + row * target.pitch());
+			auto cursor = x;
+			for (auto p = s.data.data() + s.rows[row - y], end = s.data.data() + s.rows[row - y + 1]; (p != end) && (cursor < x1);) {
+				auto kind = static_cast<run>(*p >> 24);
+				auto count = static_cast<int>(*p++ & 0xffffff);
+				if (kind == run::skip) {
+					cursor += count;
+					continue;
+				}
+
+				auto begin = std::max(cursor, x0), finish = std::min(cursor + count, x1);
+				if (begin < finish) {
+					auto pixels = p + (begin - cursor);
+					if (kind == run::copy) {
+						std::memcpy(out + begin, pixels, static_cast<std::size_t>(finish - begin) * 4);
+					} else {
+						for (auto i = begin; i < finish; ++i) out[i] = blend(*pixels++, out[i]);
+					}
+				}
+				p += count;
+				cursor += count;
+			}
+		}
+		return true;
+	}
+
+private:
+	struct sprite {
+		int width = 0;
+		int height = 0;
+		std::vector<Uint32> rows;
+		std::vector<Uint32> data;
+	};
+
+	static run classify(Uint32 pixel) noexcept {
+		auto alpha = pixel >> traits::a_shift;
+		return (alpha == 0) ? run::skip : (alpha == 0xff) ? run::copy : run::blend;
+	}
+
+	static void encode_row(const std::vector<Uint32> &line, std::vector<Uint32> &data) {
+		auto width = static_cast<int>(line.size());
+		auto last = width;
+		while ((last > 0) && (classify(line[last - 1]) == run::skip)) --last;
+
+		for (int x = 0; x < last;) {
+			auto kind = classify(line[x]);
+			auto start = x;
+			while ((x < last) && (classify(line[x]) == kind) && (x - start < 0xffffff)) ++x;
+
+			data.push_back((static_cast<Uint32>(kind) << 24) | static_cast<Uint32>(x - start));
+			if (kind != run::skip) data.insert(data.end(), line.begin() + start, line.begin() + x);
+		}
+	}
+
+	static Uint32 blend(Uint32 src, Uint32 dst) noexcept {
+		auto sa = src >> 24;
+		auto inverse = 255 - sa;
+		auto mix = [&](int shift) {
+			auto s = (src >> shift) & 0xff, d = (dst >> shift) & 0xff;
+			return (((s * sa + d * inverse) + 127) / 255) << shift;
+		};
+		auto da = dst >> 24;
+		auto alpha = sa + (da * inverse + 127) / 255;
+		return (alpha << 24) | mix(16) | mix(8) | mix(0);
+	}
+
+private:
+	std::vector<sprite> _sprites;
+	std::unique_ptr<surface> _scratch;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_SPRITE_STORE_HPP_
@@ -34,10 +34,14 @@ inline bool convert_pixels(
 	void *dst,
 	int dst_pitch
 ) noexcept {
-	return (SDL_ConvertPixels(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch) == 0);
+	try {
+		return pixel_converter::find(src_format, dst_format)->convert(width, height, src, src_pitch, dst, dst_pitch);
+	} catch (...) {
+		return (SDL_ConvertPixels(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch) == 0);
+	}
 }
 
-class surface final : public sdl::detail::resource<SDL_Surface, decltype(&SDL_FreeSurface)> {
+class surface final : public sdl::detail::static_resource<SDL_Surface, SDL_FreeSurface> {
 public:
 	template<bool b>
 	struct basic_mask {};
@@ -61,46 +65,46 @@ public:
 	using mask = basic_mask<sdl::is_big_endian>;
 
 	static decltype(auto) make_resource(Uint32 flags, int width, int height, int depth, Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask) {
-		return resource::make_resource(SDL_CreateRGBSurface, SDL_FreeSurface, flags, width, height, depth, Rmask, Gmask, Bmask, Amask);
+		return static_resource::make_resource(SDL_CreateRGBSurface, flags, width, height, depth, Rmask, Gmask, Bmask, Amask);
 	}
 
 	static decltype(auto) make_resource(void* pixels, int width, int height, int depth, int pitch, Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask) {
-		return resource::make_resource(SDL_CreateRGBSurfaceFrom, SDL_FreeSurface, pixels, width, height, depth, pitch, Rmask, Gmask, Bmask, Amask);
+		return static_resource::make_resource(SDL_CreateRGBSurfaceFrom, pixels, width, height, depth, pitch, Rmask, Gmask, Bmask, Amask);
 	}
 
 	static decltype(auto) make_resource(Uint32 flags, int width, int height, int depth, Uint32 format) {
-		return resource::make_resource(SDL_CreateRGBSurfaceWithFormat, SDL_FreeSurface, flags, width, height, depth, format);
+		return static_resource::make_resource(SDL_CreateRGBSurfaceWithFormat, flags, width, height, depth, format);
 	}
 
 	static decltype(auto) make_resource(void* pixels, int width, int height, int depth, int pitch, Uint32 format) {
-		return resource::make_resource(SDL_CreateRGBSurfaceWithFormatFrom, SDL_FreeSurface, pixels, width, height, depth, pitch, format);
+		return static_resource::make_resource(SDL_CreateRGBSurfaceWithFormatFrom, pixels, width, height, depth, pitch, format);
 	}
 
 	static decltype(auto) make_resource(const char* file) {
-		return handle_holder(SDL_LoadBMP(file), SDL_FreeSurface);
+		return handle_holder(SDL_LoadBMP(file));
 	}
 
 	static decltype(auto) make_resource(SDL_RWops* src, int freesrc) {
-		return resource::make_resource(SDL_LoadBMP_RW, SDL_FreeSurface, src, freesrc);
+		return static_resource::make_resource(SDL_LoadBMP_RW, src, freesrc);
 	}
 
 	explicit surface(Uint32 flags, int width, int height, int depth)
-		: resource(make_resource(flags, width, height, depth, mask::red, mask::green, mask::blue, mask::alpha)) {}
+		: static_resource(make_resource(flags, width, height, depth, mask::red, mask::green, mask::blue, mask::alpha)) {}
 
 	explicit surface(void* pixels, int width, int height, int depth, int pitch)
-		: resource(make_resource(pixels, width, height, depth, pitch, mask::red, mask::green, mask::blue, mask::alpha)) {}
+		: static_resource(make_resource(pixels, width, height, depth, pitch, mask::red, mask::green, mask::blue, mask::alpha)) {}
 
 	explicit surface(Uint32 flags, int width, int height, int depth, Uint32 format)
-		: resource(make_resource(flags, width, height, depth, format)) {}
+		: static_resource(make_resource(flags, width, height, depth, format)) {}
 
 	explicit surface(void* pixels, int width, int height, int depth, int pitch, Uint32 format)
-		: resource(make_resource(pixels, width, height, depth, pitch, format)) {}
+		: static_resource(make_resource(pixels, width, height, depth, pitch, format)) {}
 
 	explicit surface(const char* file)
-		: resource(make_resource(file)) {}
+		: static_resource(make_resource(file)) {}
 
 	explicit surface(SDL_RWops* src, int freesrc)
-		: resource(make_resource(src, freesrc)) {}
+		: static_resource(make_resource(src, freesrc)) {}
 
 	void create(Uint32 flags, int width, int height, int depth) {
 		_handle_holder = make_resource(flags, width, height, depth, mask::red, mask::green, mask::blue, mask::alpha);
@@ -240,6 +244,37 @@ public:
 	int refcount() const noexcept { return _handle_holder->refcount; }
 };
 
+// Locks a surface for the current scope when SDL_MUSTLOCK says it needs it.
+class surface_lock final {
+public:
+	explicit surface_lock(SDL_Surface *s) noexcept {
+		if ((s == nullptr) || !SDL_MUSTLOCK(s)) return;
+
+		if (SDL_LockSurface(s) == 0) {
+			_surface = s;
+		} else {
+			_failed = true;
+		}
+	}
+
+	explicit surface_lock(const surface &s) noexcept : surface_lock(s.get()) {}
+
+	surface_lock(const surface_lock &) = delete;
+
+	~surface_lock() {
+		if (_surface != nullptr) SDL_UnlockSurface(_surface);
+	}
+
+	surface_lock &operator =(const surface_lock &) = delete;
+
+	// False when the surface needed a lock and SDL_LockSurface failed.
+	explicit operator bool() const noexcept { return !_failed; }
+
+private:
+	SDL_Surface *_surface = nullptr;
+	bool _failed = false;
+};
+
 } } // namespace sdl::video
 
 #endif // SDL2_WRAPPER_VIDEO_SURFACE_HPP_
@@ -0,0 +1,221 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_SURFACE_VIEW_HPP_
+#define SDL2_WRAPPER_VIDEO_SURFACE_VIEW_HPP_
+
+#include <cstddef>
+#include <iterator>
+
+namespace sdl { inline namespace video {
+
+template <Uint32 Format>
+class surface_view final {
+public:
+	using traits = pixel_format_traits<Format>;
+	using pixel_type = typename traits::pixel_type;
+
+	class reference final {
+	public:
+		explicit reference(Uint8 *p) noexcept : _p(p) {}
+
+		reference(const reference &) = default;
+
+		operator color() const noexcept { return traits::unmap(traits::load(_p)); }
+
+		reference &operator =(const color &c) noexcept { traits::store(_p, traits::map(c)); return *this; }
+
+		reference &operator =(const reference &rhs) noexcept { traits::store(_p, traits::load(rhs._p)); return *this; }
+
+		Uint32 raw() const noexcept { return traits::load(_p); }
+
+		void raw(Uint32 pixel) noexcept { traits::store(_p, pixel); }
+
+	private:
+		Uint8 *_p;
+	};
+
+	// Dereferencing yields a proxy rather than a color &, so the iterator only
+	// claims input iterator requirements even though it supports arithmetic.
+	class iterator final {
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = color;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = surface_view::reference;
+
+		iterator() noexcept = default;
+
+		explicit iterator(Uint8 *p) noexcept : _p(p) {}
+
+		reference operator *() const noexcept { return reference(_p); }
+
+		reference operator [](difference_type n) const noexcept { return reference(_p + n * traits::bytes_per_pixel); }
+
+		iterator &operator ++() noexcept { _p += traits::bytes_per_pixel; return *this; }
+
+		iterator operator ++(int) noexcept { auto result = *this; ++*this; return result; }
+
+		iterator &operator --() noexcept { _p -= traits::bytes_per_pixel; return *this; }
+
+		iterator operator --(int) noexcept { auto result = *this; --*this; return result; }
+
+		iterator &operator +=(difference_type n) noexcept { _p += n * traits::bytes_per_pixel; return *this; }
+
+		iterator &operator -=(difference_type n) noexcept { _p -= n * traits::bytes_per_pixel; return *this; }
+
+		iterator operator +(difference_type n) const noexcept { return iterator(_p + n * traits::bytes_per_pixel); }
+
+		friend iterator operator +(difference_type n, const iterator &it) noexcept { return it + n; }
+
+		iterator operator -(difference_type n) const noexcept { return iterator(_p - n * traits::bytes_per_pixel); }
+
+		difference_type operator -(const iterator &rhs) const noexcept { return (_p - rhs._p) / traits::bytes_per_pixel; }
+
+		bool operator ==(const iterator &rhs) const noexcept { return (_p == rhs._p); }
+		bool operator !=(const iterator &rhs) const noexcept { return (_p != rhs._p); }
+		bool operator <(const iterator &rhs) const noexcept { return (_p < rhs._p); }
+		bool operator >(const iterator &rhs) const noexcept { return (_p > rhs._p); }
+		bool operator <=(const iterator &rhs) const noexcept { return (_p <= rhs._p); }
+		bool operator >=(const iterator &rhs) const noexcept { return (_p >= rhs._p); }
+
+	private:
+		Uint8 *_p = nullptr;
+	};
+
+	class row_range final {
+	public:
+		row_range(Uint8 *p, int width) noexcept : _p(p), _width(width) {}
+
+		iterator begin() const noexcept { return iterator(_p); }
+
+		iterator end() const noexcept { return iterator(_p + _width * traits::bytes_per_pixel); }
+
+		int size() const noexcept { return _width; }
+
+		reference operator [](int x) const noexcept { return reference(_p + x * traits::bytes_per_pixel); }
+
+	private:
+		Uint8 *_p;
+		int _width;
+	};
+
+public:
+	surface_view() noexcept = default;
+
+	// Locks the surface for the lifetime of the view when SDL_MUSTLOCK says so.
+	// A surface that fails to lock yields an invalid view.
+	explicit surface_view(SDL_Surface *s) noexcept {
+		if ((s == nullptr) || (s->format == nullptr) || (s->format->format != Format)) return;
+
+		if (SDL_MUSTLOCK(s)) {
+			if (SDL_LockSurface(s) != 0) return;
+			_locked = s;
+		}
+		_pixels = static_cast<Uint8 *>(s->pixels);
+		_width = s->w;
+		_height = s->h;
+		_pitch = s->pitch;
+	}
+
+	explicit surface_view(const surface &s) noexcept : surface_view(s.get()) {}
+
+	surface_view(void *pixels, int width, int height, int pitch) noexcept
+		: _pixels(static_cast<Uint8 *>(pixels)), _width(width), _height(height), _pitch(pitch) {}
+
+	surface_view(const surface_view &) = delete;
+
+	surface_view(surface_view &&rhs) noexcept
+		: _pixels(rhs._pixels), _width(rhs._width), _height(rhs._height), _pitch(rhs._pitch), _locked(rhs._locked) {
+		rhs._locked = nullptr;
+	}
+
+	~surface_view() { unlock(); }
+
+	surface_view &operator =(const surface_view &) = delete;
+
+	surface_view &operator =(surface_view &&rhs) noexcept {
+		if (this != &rhs) {
+			unlock();
+			_pixels = rhs._pixels;
+			_width = rhs._width;
+			_height = rhs._height;
+			_pitch = rhs._pitch;
+			_locked = rhs._locked;
+			rhs._locked = nullptr;
+		}
+		return *this;
+	}
+
+	bool valid() const noexcept { return (_pixels != nullptr); }
+
+	explicit operator bool() const noexcept { return valid(); }
+
+	int w() const noexcept { return _width; }
+
+	int h() const noexcept { return _height; }
+
+	int pitch() const noexcept { return _pitch; }
+
+	Uint8 *data() const noexcept { return _pixels; }
+
+	bool contains(int x, int y) const noexcept { return (x >= 0) && (y >= 0) && (x < _width) && (y < _height); }
+
+	color get(int x, int y) const noexcept { return traits::unmap(traits::load(address(x, y))); }
+
+	void set(int x, int y, const color &c) const noexcept { traits::store(address(x, y), traits::map(c)); }
+
+	Uint32 raw(int x, int y) const noexcept { return traits::load(address(x, y)); }
+
+	void raw(int x, int y, Uint32 pixel) const noexcept { traits::store(address(x, y), pixel); }
+
+	reference operator ()(int x, int y) const noexcept { return reference(address(x, y)); }
+
+	row_range row(int y) const noexcept { return row_range(_pixels + y * _pitch, _width); }
+
+	void fill(const color &c) const noexcept {
+		auto pixel = traits::map(c);
+		for (int y = 0; y < _height; ++y) {
+			auto p = _pixels + y * _pitch;
+			for (int x = 0; x < _width; ++x, p += traits::bytes_per_pixel) traits::store(p, pixel);
+		}
+	}
+
+private:
+	Uint8 *address(int x, int y) const noexcept { return _pixels + y * _pitch + x * traits::bytes_per_pixel; }
+
+	void unlock() noexcept {
+		if (_locked != nullptr) SDL_UnlockSurface(_locked);
+		_locked = nullptr;
+	}
+
+private:
+	Uint8 *_pixels = nullptr;
+	int _width = 0;
+	int _height = 0;
+	int _pitch = 0;
+	SDL_Surface *_locked = nullptr;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_SURFACE_VIEW_HPP_
@@ -24,21 +24,21 @@
 
 namespace sdl { inline namespace video {
 
-class texture final : public sdl::detail::resource<SDL_Texture, decltype(&SDL_DestroyTexture)> {
+class texture final : public sdl::detail::static_resource<SDL_Texture, SDL_DestroyTexture> {
 public:
 	static decltype(auto) make_resource(SDL_Renderer* renderer, Uint32 format, int access, int w, int h) {
-		return resource::make_resource(SDL_CreateTexture, SDL_DestroyTexture, renderer, format, access, w, h);
+		return static_resource::make_resource(SDL_CreateTexture, renderer, format, access, w, h);
 	}
 
 	static decltype(auto) make_resource(SDL_Renderer* renderer, SDL_Surface* surface) {
-		return resource::make_resource(SDL_CreateTextureFromSurface, SDL_DestroyTexture, renderer, surface);
+		return static_resource::make_resource(SDL_CreateTextureFromSurface, renderer, surface);
 	}
 
 	explicit texture(SDL_Renderer* renderer, Uint32 format, int access, int w, int h)
-		: resource(make_resource(renderer, format, access, w, h)) {}
+		: static_resource(make_resource(renderer, format, access, w, h)) {}
 
 	explicit texture(SDL_Renderer* renderer, SDL_Surface* surface)
-		: resource(make_resource(renderer, surface)) {}
+		: static_resource(make_resource(renderer, surface)) {}
 
 	void create(SDL_Renderer* renderer, Uint32 format, int access, int w, int h) {
 		_handle_holder = make_resource(renderer, format, access, w, h);
@@ -81,6 +81,30 @@ public:
 	void unlock() { SDL_UnlockTexture(get()); }
 };
 
+static_assert(sizeof(texture) == sizeof(SDL_Texture *), "texture must be pointer-sized");
+
+// Approximate pixel storage of a texture. Packed YUV formats take two bytes
+// per pixel and other FourCC formats are counted as 4:2:0 planar.
+inline std::size_t texture_size(SDL_Texture *t) noexcept {
+	Uint32 format = SDL_PIXELFORMAT_UNKNOWN;
+	int w = 0, h = 0;
+	if ((t == nullptr) || (SDL_QueryTexture(t, &format, nullptr, &w, &h) != 0)) return 0;
+
+	auto pixels = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+	switch (format) {
+	case SDL_PIXELFORMAT_YUY2:
+	case SDL_PIXELFORMAT_UYVY:
+	case SDL_PIXELFORMAT_YVYU:
+		return pixels * 2;
+
+	default:
+		if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+			return pixels + 2 * (static_cast<std::size_t>((w + 1) / 2) * static_cast<std::size_t>((h + 1) / 2));
+		}
+		return pixels * SDL_BYTESPERPIXEL(format);
+	}
+}
+
 } } // namespace sdl::video
 
 #endif // SDL2_WRAPPER_VIDEO_TEXTURE_HPP_
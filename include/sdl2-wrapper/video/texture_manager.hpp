@@ -0,0 +1,225 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_TEXTURE_MANAGER_HPP_
+#define SDL2_WRAPPER_VIDEO_TEXTURE_MANAGER_HPP_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class texture_manager final {
+public:
+	using id_type = std::size_t;
+	using loader = std::function<std::shared_ptr<surface> ()>;
+
+	static constexpr id_type invalid_id = static_cast<id_type>(-1);
+
+	struct frame_statistics {
+		Uint64 frame = 0;
+		std::size_t used = 0;
+		std::size_t hits = 0;
+		std::size_t uploads = 0;
+		std::size_t uploaded_bytes = 0;
+		std::size_t evictions = 0;
+		std::size_t failures = 0;
+		std::size_t resident = 0;
+		std::size_t resident_bytes = 0;
+		bool over_budget = false;
+	};
+
+public:
+	texture_manager(renderer &renderer, std::size_t budget) : _renderer(renderer), _budget(budget) {}
+
+	texture_manager(const texture_manager &) = delete;
+
+	texture_manager &operator =(const texture_manager &) = delete;
+
+	id_type add(loader load, bool keep_source = false) {
+		entry e;
+		e.load = std::move(load);
+		e.keep_source = keep_source;
+		_entries.push_back(std::move(e));
+		return _entries.size() - 1;
+	}
+
+	id_type add(std::shared_ptr<surface> source) {
+		auto id = add([source] { return source; }, true);
+		_entries[id].source = std::move(source);
+		return id;
+	}
+
+	id_type add(const std::string &path) {
+		return add([path] {
+			auto result = std::make_shared<surface>(path.c_str());
+			return result->valid() ? result : nullptr;
+		});
+	}
+
+	bool contains(id_type id) const noexcept { return (id < _entries.size()) && _entries[id].load; }
+
+	bool resident(id_type id) const noexcept { return contains(id) && _entries[id].handle; }
+
+	// Textures acquired since the last begin_frame() are never evicted. Before
+	// the first frame begins, only the texture being acquired is protected.
+	void begin_frame() noexcept {
+		auto frame = _stats.frame + 1;
+		_stats = frame_statistics();
+		_stats.frame = frame;
+		_stats.resident = _resident;
+		_stats.resident_bytes = _resident_bytes;
+		_stats.over_budget = (_resident_bytes > _budget);
+	}
+
+	const frame_statistics &stats() const noexcept { return _stats; }
+
+	SDL_Texture *acquire(id_type id) {
+		if (!contains(id)) return nullptr;
+
+		auto &e = _entries[id];
+		if (e.last_frame != _stats.frame) {
+			e.last_frame = _stats.frame;
+			++_stats.used;
+		}
+
+		if (e.handle) {
+			++_stats.hits;
+			_lru.splice(_lru.begin(), _lru, e.position);
+			return e.handle->get();
+		}
+
+		auto source = e.source ? e.source : e.load();
+		if (!source || !source->valid()) {
+			++_stats.failures;
+			return nullptr;
+		}
+
+		auto created = std::make_unique<texture>(_renderer.get(), source->get());
+		if (!created->valid()) {
+			++_stats.failures;
+			return nullptr;
+		}
+		if (e.keep_source) e.source = std::move(source);
+
+		e.handle = std::move(created);
+		e.bytes = texture_size(e.handle->get());
+		_lru.push_front(id);
+		e.position = _lru.begin();
+
+		++_resident;
+		_resident_bytes += e.bytes;
+		++_stats.uploads;
+		_stats.uploaded_bytes += e.bytes;
+
+		trim(id);
+		return e.handle->get();
+	}
+
+	bool copy(id_type id, const SDL_Rect *srcrect = nullptr, const SDL_Rect *dstrect = nullptr) {
+		auto t = acquire(id);
+		return (t != nullptr) && _renderer.copy(t, srcrect, dstrect);
+	}
+
+	bool evict(id_type id) noexcept {
+		if (!resident(id)) return false;
+
+		auto &e = _entries[id];
+		_lru.erase(e.position);
+		e.handle.reset();
+		--_resident;
+		_resident_bytes -= e.bytes;
+		e.bytes = 0;
+		++_stats.evictions;
+		return true;
+	}
+
+	void remove(id_type id) noexcept {
+		if (!contains(id)) return;
+
+		evict(id);
+		_entries[id] = entry();
+	}
+
+	void clear() noexcept {
+		for (id_type id = 0; id < _entries.size(); ++id) evict(id);
+		_entries.clear();
+	}
+
+	void trim() noexcept { trim(invalid_id); }
+
+	std::size_t budget() const noexcept { return _budget; }
+
+	void budget(std::size_t bytes) noexcept {
+		_budget = bytes;
+		trim();
+	}
+
+	std::size_t resident_bytes() const noexcept { return _resident_bytes; }
+
+	std::size_t resident_count() const noexcept { return _resident; }
+
+	std::size_t size() const noexcept { return _entries.size(); }
+
+private:
+	static constexpr Uint64 never = static_cast<Uint64>(-1);
+
+	struct entry {
+		loader load;
+		std::shared_ptr<surface> source;
+		bool keep_source = false;
+		std::unique_ptr<texture> handle;
+		std::size_t bytes = 0;
+		Uint64 last_frame = never;
+		std::list<id_type>::iterator position;
+	};
+
+	void trim(id_type keep) noexcept {
+		auto it = _lru.end();
+		while ((_resident_bytes > _budget) && (it != _lru.begin())) {
+			--it;
+			auto id = *it;
+			if ((id == keep) || ((_stats.frame != 0) && (_entries[id].last_frame == _stats.frame))) continue;
+
+			it = std::next(it);
+			evict(id);
+		}
+		_stats.resident = _resident;
+		_stats.resident_bytes = _resident_bytes;
+		_stats.over_budget = (_resident_bytes > _budget);
+	}
+
+private:
+	renderer &_renderer;
+	std::size_t _budget;
+	std::vector<entry> _entries;
+	std::list<id_type> _lru;
+	std::size_t _resident = 0;
+	std::size_t _resident_bytes = 0;
+	frame_statistics _stats;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_TEXTURE_MANAGER_HPP_
@@ -0,0 +1,317 @@
+/*
+	sdl2-wrapper - C++ wrapper for SDL2
+	Copyright (c) 2016 Remy Roez <remyroez@gmail.com>
+
+	This software is provided 'as-is', without any express or implied
+	warranty. In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+		claim that you wrote the original software. If you use this software
+		in a product, an acknowledgment in the product documentation would be
+		appreciated but is not required.
+	2. Altered source versions must be plainly marked as such, and must not be
+		misrepresented as being the original software.
+	3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SDL2_WRAPPER_VIDEO_TILEMAP_RENDERER_HPP_
+#define SDL2_WRAPPER_VIDEO_TILEMAP_RENDERER_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace sdl { inline namespace video {
+
+class tilemap_renderer final {
+public:
+	using tile_type = Uint16;
+
+	static constexpr tile_type empty_tile = 0xFFFF;
+
+	struct statistics {
+		std::size_t visible = 0;
+		std::size_t redrawn = 0;
+		std::size_t released = 0;
+		std::size_t tiles = 0;
+		std::size_t copies = 0;
+	};
+
+public:
+	explicit tilemap_renderer(
+		renderer &renderer,
+		SDL_Texture *tileset,
+		int tile_width,
+		int tile_height,
+		int columns,
+		int rows,
+		int chunk_size = 16
+	) : _renderer(renderer),
+		_tileset(tileset),
+		_tile_width(std::max(tile_width, 1)),
+		_tile_height(std::max(tile_height, 1)),
+		_columns(std::max(columns, 0)),
+		_rows(std::max(rows, 0)),
+		_chunk_size(std::max(chunk_size, 1)),
+		_tiles(static_cast<std::size_t>(_columns) * static_cast<std::size_t>(_rows), static_cast<tile_type>(empty_tile)) {
+		int w = 0;
+		if ((_tileset != nullptr) && (SDL_QueryTexture(_tileset, nullptr, nullptr, &w, nullptr) == 0)) {
+			_tileset_columns = std::max(w / _tile_width, 1);
+		}
+
+		_chunk_columns = (_columns + _chunk_size - 1) / _chunk_size;
+		_chunk_rows = (_rows + _chunk_size - 1) / _chunk_size;
+		_chunks.resize(static_cast<std::size_t>(_chunk_columns) * static_cast<std::size_t>(_chunk_rows));
+		_cached = _renderer.render_target_supported();
+	}
+
+	tilemap_renderer(const tilemap_renderer &) = delete;
+
+	tilemap_renderer &operator =(const tilemap_renderer &) = delete;
+
+	int columns() const noexcept { return _columns; }
+
+	int rows() const noexcept { return _rows; }
+
+	point tile_size() const noexcept { return { _tile_width, _tile_height }; }
+
+	point pixel_size() const noexcept { return { _columns * _tile_width, _rows * _tile_height }; }
+
+	bool cached() const noexcept { return _cached; }
+
+	void cached(bool enable) noexcept {
+		_cached = enable && _renderer.render_target_supported();
+		if (!_cached) release();
+	}
+
+	std::size_t max_resident() const noexcept { return _max_resident; }
+
+	void max_resident(std::size_t chunks) noexcept { _max_resident = chunks; }
+
+	tile_type get(int x, int y) const noexcept {
+		return contains(x, y) ? _tiles[index(x, y)] : static_cast<tile_type>(empty_tile);
+	}
+
+	void set(int x, int y, tile_type tile) noexcept {
+		if (!contains(x, y)) return;
+
+		auto &current = _tiles[index(x, y)];
+		if (current == tile) return;
+
+		current = tile;
+		chunk_at(x / _chunk_size, y / _chunk_size).dirty = true;
+	}
+
+	void fill(tile_type tile) noexcept {
+		std::fill(_tiles.begin(), _tiles.end(), tile);
+		invalidate();
+	}
+
+	void invalidate() noexcept {
+		for (auto &c : _chunks) c.dirty = true;
+	}
+
+	void invalidate(const rect &area) noexcept {
+		auto first_x = std::max(area.left() / _tile_width / _chunk_size, 0);
+		auto first_y = std::max(area.top() / _tile_height / _chunk_size, 0);
+		auto last_x = std::min((area.right() - 1) / _tile_width / _chunk_size, _chunk_columns - 1);
+		auto last_y = std::min((area.bottom() - 1) / _tile_height / _chunk_size, _chunk_rows - 1);
+		for (auto cy = first_y; cy <= last_y; ++cy) {
+			for (auto cx = first_x; cx <= last_x; ++cx) chunk_at(cx, cy).dirty = true;
+		}
+	}
+
+	void release() noexcept {
+		for (auto &c : _chunks) {
+			if (c.target) {
+				c.target.reset();
+				c.dirty = true;
+				--_resident;
+			}
+		}
+	}
+
+	bool draw(int camera_x, int camera_y) {
+		_stats = statistics();
+		++_frame;
+
+		auto view = _renderer.viewport();
+		if ((_tileset == nullptr) || (view.w <= 0) || (view.h <= 0)) return false;
+
+		// SDL reports the viewport in scaled units, truncated to whole pixels, so
+		// widen it by one unit under a fractional scale to keep the partly
+		// covered last row and column.
+		float scale_x = 1.0f, scale_y = 1.0f;
+		_renderer.scale(&scale_x, &scale_y);
+		rect visible(camera_x, camera_y, view.w + ((scale_x != 1.0f) ? 1 : 0), view.h + ((scale_y != 1.0f) ? 1 : 0));
+		auto first_x = std::max(floor_div(visible.left(), _tile_width * _chunk_size), 0);
+		auto first_y = std::max(floor_div(visible.top(), _tile_height * _chunk_size), 0);
+		auto last_x = std::min(floor_div(visible.right() - 1, _tile_width * _chunk_size), _chunk_columns - 1);
+		auto last_y = std::min(floor_div(visible.bottom() - 1, _tile_height * _chunk_size), _chunk_rows - 1);
+
+		bool result = true;
+		for (auto cy = first_y; cy <= last_y; ++cy) {
+			for (auto cx = first_x; cx <= last_x; ++cx) {
+				++_stats.visible;
+				result &= _cached ? draw_cached(cx, cy, visible, camera_x, camera_y) : draw_direct(cx, cy, visible, camera_x, camera_y);
+			}
+		}
+
+		if (_resident > _max_resident) evict();
+		return result;
+	}
+
+	bool draw(const point &camera) { return draw(camera.x, camera.y); }
+
+	const statistics &stats() const noexcept { return _stats; }
+
+private:
+	struct chunk {
+		std::unique_ptr<texture> target;
+		bool dirty = true;
+		Uint64 last_frame = 0;
+	};
+
+	static int floor_div(int a, int b) noexcept { return (a >= 0) ? (a / b) : -((-a + b - 1) / b); }
+
+	bool contains(int x, int y) const noexcept { return (x >= 0) && (y >= 0) && (x < _columns) && (y < _rows); }
+
+	std::size_t index(int x, int y) const noexcept {
+		return static_cast<std::size_t>(y) * static_cast<std::size_t>(_columns) + static_cast<std::size_t>(x);
+	}
+
+	chunk &chunk_at(int cx, int cy) noexcept {
+		return _chunks[static_cast<std::size_t>(cy) * static_cast<std::size_t>(_chunk_columns) + static_cast<std::size_t>(cx)];
+	}
+
+	rect chunk_bounds(int cx, int cy) const noexcept {
+		auto x = cx * _chunk_size;
+		auto y = cy * _chunk_size;
+		return rect(
+			x * _tile_width,
+			y * _tile_height,
+			(std::min(x + _chunk_size, _columns) - x) * _tile_width,
+			(std::min(y + _chunk_size, _rows) - y) * _tile_height
+		);
+	}
+
+	bool draw_tiles(int cx, int cy, const rect &area, int offset_x, int offset_y) noexcept {
+		auto first_x = std::max(area.left() / _tile_width, cx * _chunk_size);
+		auto first_y = std::max(area.top() / _tile_height, cy * _chunk_size);
+		auto last_x = std::min((area.right() - 1) / _tile_width, std::min((cx + 1) * _chunk_size, _columns) - 1);
+		auto last_y = std::min((area.bottom() - 1) / _tile_height, std::min((cy + 1) * _chunk_size, _rows) - 1);
+
+		bool result = true;
+		for (auto y = first_y; y <= last_y; ++y) {
+			for (auto x = first_x; x <= last_x; ++x) {
+				auto tile = _tiles[index(x, y)];
+				if (tile == empty_tile) continue;
+
+				rect src((tile % _tileset_columns) * _tile_width, (tile / _tileset_columns) * _tile_height, _tile_width, _tile_height);
+				rect dst(x * _tile_width - offset_x, y * _tile_height - offset_y, _tile_width, _tile_height);
+				result &= _renderer.copy(_tileset, &src, &dst);
+				++_stats.tiles;
+				++_stats.copies;
+			}
+		}
+		return result;
+	}
+
+	bool draw_direct(int cx, int cy, const rect &visible, int camera_x, int camera_y) noexcept {
+		rect area;
+		if (!chunk_bounds(cx, cy).intersect(visible, area)) return true;
+
+		return draw_tiles(cx, cy, area, camera_x, camera_y);
+	}
+
+	bool draw_cached(int cx, int cy, const rect &visible, int camera_x, int camera_y) {
+		auto &c = chunk_at(cx, cy);
+		auto bounds = chunk_bounds(cx, cy);
+		c.last_frame = _frame;
+
+		if (!c.target) {
+			c.target = std::make_unique<texture>(_renderer.get(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, bounds.w, bounds.h);
+			if (!c.target->valid()) {
+				c.target.reset();
+				return draw_direct(cx, cy, visible, camera_x, camera_y);
+			}
+			c.target->blend_mode(SDL_BLENDMODE_BLEND);
+			c.dirty = true;
+			++_resident;
+		}
+
+		if (c.dirty && !redraw(cx, cy, c, bounds)) return false;
+
+		rect dst(bounds.x - camera_x, bounds.y - camera_y, bounds.w, bounds.h);
+		++_stats.copies;
+		return _renderer.copy(c.target->get(), nullptr, &dst);
+	}
+
+	bool redraw(int cx, int cy, chunk &c, const rect &bounds) noexcept {
+		auto previous = _renderer.render_target();
+		auto view = _renderer.viewport();
+
+		// Copy tiles into the transparent chunk unblended; the chunk itself is
+		// blended when drawn, so blending here too would apply alpha twice.
+		SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+		auto restore = (SDL_GetTextureBlendMode(_tileset, &mode) == 0) && (mode != SDL_BLENDMODE_NONE) &&
+			(SDL_SetTextureBlendMode(_tileset, SDL_BLENDMODE_NONE) == 0);
+
+		_renderer.render_target(c.target->get());
+		bool result = _renderer.clear(0, 0, 0, 0) && draw_tiles(cx, cy, bounds, bounds.x, bounds.y);
+		_renderer.render_target(previous);
+		_renderer.viewport(&view);
+
+		if (restore) SDL_SetTextureBlendMode(_tileset, mode);
+
+		c.dirty = !result;
+		++_stats.redrawn;
+		return result;
+	}
+
+	void evict() {
+		std::vector<chunk *> candidates;
+		for (auto &c : _chunks) {
+			if (c.target && (c.last_frame != _frame)) candidates.push_back(&c);
+		}
+
+		auto count = std::min(_resident - _max_resident, candidates.size());
+		std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [](const chunk *a, const chunk *b) {
+			return a->last_frame < b->last_frame;
+		});
+		for (std::size_t i = 0; i < count; ++i) {
+			candidates[i]->target.reset();
+			candidates[i]->dirty = true;
+			--_resident;
+			++_stats.released;
+		}
+	}
+
+private:
+	renderer &_renderer;
+	SDL_Texture *_tileset;
+	int _tile_width;
+	int _tile_height;
+	int _tileset_columns = 1;
+	int _columns;
+	int _rows;
+	int _chunk_size;
+	int _chunk_columns = 0;
+	int _chunk_rows = 0;
+	std::vector<tile_type> _tiles;
+	std::vector<chunk> _chunks;
+	bool _cached = true;
+	std::size_t _resident = 0;
+	std::size_t _max_resident = 256;
+	Uint64 _frame = 0;
+	statistics _stats;
+};
+
+} } // namespace sdl::video
+
+#endif // SDL2_WRAPPER_VIDEO_TILEMAP_RENDERER_HPP_
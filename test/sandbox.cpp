@@ -1,5 +1,14 @@
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// benchmarkLogFormat() measures a category removed at compile time
+#define SDL2_WRAPPER_LOG_DISABLED_CATEGORIES (1ULL << SDL_LOG_CATEGORY_RESERVED10)
 
 #include <SDL2\SDL.h>
 #include "sdl2-wrapper/sdl.hpp"
@@ -17,6 +26,1218 @@ void printError()
 	sdl::log::error(sdl::log::category::error, "Error: %s", sdl::error::get());
 }
 
+struct blob
+{
+	std::size_t size;
+};
+
+std::size_t resource_size(const blob &b)
+{
+	return b.size;
+}
+
+bool checkResourceCache()
+{
+	// synthetic workload: 64 keys of 100 bytes, nine lookups in ten hit a
+	// hot set of 8 keys, and the budget holds 16 of them
+	std::size_t loads = 0;
+	sdl::resource_cache<int, blob> cache(1600, [&loads](const int &) {
+		++loads;
+		return std::make_shared<blob>(blob { 100 });
+	});
+
+	bool ok = true;
+	Uint32 seed = 12345;
+	for (int i = 0; i < 10000; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		auto key = ((seed >> 8) % 10 != 0) ? static_cast<int>((seed >> 16) % 8) : static_cast<int>((seed >> 16) % 64);
+		auto resource = cache.get(key);
+		ok = ok && resource && (resource->size == 100) && (cache.bytes() <= 1600);
+	}
+
+	auto stats = cache.stats();
+	ok = ok && (stats.misses == loads) && (stats.hits > stats.misses);
+
+	// timing: 16 surfaces decoded from a 256x256 QOI image on a miss, then
+	// fetched 100 times each from a cache with room for all of them
+	std::vector<Uint32> gradient(256 * 256);
+	for (std::size_t i = 0; i < gradient.size(); ++i) gradient[i] = 0xFF000000 | static_cast<Uint32>(i);
+	std::vector<Uint8> encoded;
+	ok = ok && sdl::image_encoder::encode(sdl::image_encoder::format::qoi, gradient.data(), 256, 256, 256 * 4, SDL_PIXELFORMAT_ARGB8888, encoded);
+
+	sdl::resource_cache<int, sdl::surface> surfaces(32 * 256 * 256 * 4, [&encoded](const int &) {
+		return std::shared_ptr<sdl::surface>(sdl::image_loader::load(encoded.data(), encoded.size()));
+	});
+
+	auto start = SDL_GetPerformanceCounter();
+	for (int key = 0; key < 16; ++key) ok = ok && (surfaces.get(key) != nullptr);
+	auto cold = SDL_GetPerformanceCounter() - start;
+
+	start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < 1600; ++i) ok = ok && (surfaces.get(i % 16) != nullptr);
+	auto cached = SDL_GetPerformanceCounter() - start;
+	ok = ok && (surfaces.stats().misses == 16);
+
+	auto us = 1000000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+	std::cout << "resource_cache: hits " << stats.hits
+		<< ", misses " << stats.misses
+		<< ", evictions " << stats.evictions
+		<< ", cold load " << static_cast<double>(cold) * us / 16 << " us"
+		<< ", cached get " << static_cast<double>(cached) * us / 1600 << " us"
+		<< (ok ? " ok" : " failed") << std::endl;
+	return ok;
+}
+
+long fibonacci(sdl::task_system &tasks, int n)
+{
+	if (n < 16) {
+		long a = 0, b = 1;
+		for (int i = 0; i < n; ++i) {
+			auto t = a + b;
+			a = b;
+			b = t;
+		}
+		return a;
+	}
+
+	long x = 0;
+	sdl::task_system::group group;
+	tasks.run(group, [&tasks, &x, n] { x = fibonacci(tasks, n - 1); });
+	auto y = fibonacci(tasks, n - 2);
+	tasks.wait(group);
+	return x + y;
+}
+
+bool checkTaskSystem()
+{
+	// stress: fine and coarse parallel_for, nested fork/join and
+	// continuations, repeated so that workers idle and wake many times
+	sdl::task_system tasks;
+
+	bool ok = true;
+	for (int round = 0; (round < 50) && ok; ++round) {
+		std::vector<int> values(50000, 0);
+		tasks.parallel_for(0, static_cast<int>(values.size()), 16 << (round % 8), [&values](int begin, int end) {
+			for (int i = begin; i < end; ++i) values[i] += i;
+		});
+		for (int i = 0; i < static_cast<int>(values.size()); ++i) ok = ok && (values[i] == i);
+
+		std::atomic<long> sum { 0 };
+		tasks.parallel_for(0, 1000, [&sum](int begin, int end) {
+			for (int i = begin; i < end; ++i) sum += i;
+		});
+		ok = ok && (sum == 499500);
+	}
+	ok = ok && (fibonacci(tasks, 27) == 196418);
+
+	std::atomic<int> count { 0 }, seen { -1 };
+	sdl::task_system::group group;
+	for (int i = 0; i < 1000; ++i) tasks.run(group, [&count] { ++count; });
+	tasks.then(group, [&count, &seen] { seen = count.load(); });
+	tasks.wait(group);
+	while (seen < 0) std::this_thread::yield();
+	ok = ok && (seen == 1000);
+
+	std::cout << "task_system: " << (ok ? "ok" : "failed") << std::endl;
+	return ok;
+}
+
+bool checkFrameClock()
+{
+	// pacing harness: one second each at 60, 120 and 240 Hz with up to three
+	// quarters of a frame of simulated work and a fixed update at half the
+	// frame rate; frames should average the target period and about half of
+	// them should run an update
+	bool result = true;
+	for (int rate : { 60, 120, 240 }) {
+		sdl::timer::frame_clock clock(rate, rate / 2.0);
+		auto period_ms = 1000.0 / rate;
+
+		unsigned int updates = 0;
+		for (int i = 0; i < rate; ++i) {
+			updates += clock.begin_frame();
+			sdl::timer::delay(static_cast<Uint32>((i % 4) * 1000 / (rate * 4)));
+			clock.end_frame();
+		}
+
+		auto &stats = clock.stats();
+		auto frames = static_cast<unsigned int>(rate);
+		auto ok = (stats.frames == frames) && (stats.paced + stats.resyncs == frames) &&
+			(stats.mean_ms > period_ms * 0.9) && (stats.mean_ms < period_ms * 1.2) &&
+			(updates >= frames * 2 / 5) && (updates <= frames * 3 / 5);
+		std::cout << "frame_clock " << rate << " Hz: mean " << stats.mean_ms << " ms"
+			<< ", stddev " << stats.stddev_ms() << " ms"
+			<< ", mean error " << stats.mean_error_ms << " ms"
+			<< ", max error " << stats.max_error_ms << " ms"
+			<< ", resyncs " << stats.resyncs
+			<< ", updates " << updates
+			<< (ok ? " ok" : " failed") << std::endl;
+		result = result && ok;
+	}
+	return result;
+}
+
+bool checkTextureManager()
+{
+	// software renderer over a surface: 8 textures of 16x16 ARGB8888 under
+	// a budget of 3, first before any frame begins, then two per frame
+	sdl::surface canvas(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::renderer renderer(canvas.get());
+	if (!canvas || !renderer) {
+		printError();
+		return false;
+	}
+
+	const std::size_t size = 16 * 16 * 4;
+	sdl::texture_manager textures(renderer, size * 3);
+	std::vector<sdl::texture_manager::id_type> ids;
+	for (int i = 0; i < 8; ++i) {
+		auto source = std::make_shared<sdl::surface>(0, 16, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+		source->fill_rect(nullptr, static_cast<Uint32>(0xFF000000 | (i * 0x1F1F1F)));
+		ids.push_back(textures.add(source));
+	}
+
+	bool ok = true;
+	for (auto id : ids) ok = ok && (textures.acquire(id) != nullptr);
+	ok = ok && (textures.resident_bytes() <= size * 3);
+
+	for (int frame = 0; frame < 8; ++frame) {
+		textures.begin_frame();
+		ok = ok && textures.copy(ids[frame]) && textures.copy(ids[(frame + 3) % 8]);
+		ok = ok && (textures.resident_bytes() <= size * 3);
+	}
+
+	auto &stats = textures.stats();
+	ok = ok && (stats.used == 2);
+	std::cout << "texture_manager: resident " << textures.resident_count()
+		<< ", bytes " << textures.resident_bytes()
+		<< ", evictions " << stats.evictions
+		<< (ok ? " ok" : " failed") << std::endl;
+	return ok;
+}
+
+bool checkEventRecording()
+{
+	// round trip: record a few events, then decode them from data()
+	std::vector<SDL_Event> events(4);
+	for (auto &e : events) SDL_zero(e);
+	events[0].type = SDL_KEYDOWN;
+	events[0].key.keysym.scancode = SDL_SCANCODE_A;
+	events[1].type = SDL_MOUSEMOTION;
+	events[1].motion.x = 12;
+	events[1].motion.y = 34;
+	events[2].type = SDL_TEXTINPUT;
+	SDL_strlcpy(events[2].text.text, "hello", sizeof(events[2].text.text));
+	events[3].type = SDL_USEREVENT;
+	events[3].user.code = 7;
+
+	sdl::event_recorder recorder;
+	for (auto &e : events) recorder.record(e);
+
+	sdl::event_player player(recorder.data(), sdl::event_player::timing::fast);
+	bool ok = player.valid() && (player.size() == events.size());
+	for (auto &expected : events) {
+		SDL_Event e;
+		ok = ok && player.next(e) && (e.type == expected.type);
+		if (!ok) break;
+
+		switch (e.type) {
+		case SDL_KEYDOWN: ok = (e.key.keysym.scancode == expected.key.keysym.scancode); break;
+		case SDL_MOUSEMOTION: ok = (e.motion.x == expected.motion.x) && (e.motion.y == expected.motion.y); break;
+		case SDL_TEXTINPUT: ok = (SDL_strcmp(e.text.text, expected.text.text) == 0); break;
+		case SDL_USEREVENT: ok = (e.user.code == expected.user.code); break;
+		}
+	}
+	ok = ok && player.finished();
+
+	std::cout << "event_recorder: " << recorder.stats().bytes << " bytes"
+		<< (ok ? " ok" : " failed") << std::endl;
+	return ok;
+}
+
+double elapsedMs(Uint64 start)
+{
+	return static_cast<double>(sdl::timer::peformance_counter() - start) * 1000.0 / static_cast<double>(sdl::timer::peformance_frequency());
+}
+
+void benchmarkTimerWheel()
+{
+	// 100k repeating timers of 1-60000 ms advanced through ten seconds of
+	// 60 Hz frames, against adding and removing as many SDL timers
+	const int count = 100000;
+	sdl::timer::timer_wheel wheel(0);
+	std::vector<sdl::timer::timer_wheel::handle> handles;
+	handles.reserve(count);
+
+	std::size_t fired = 0;
+	Uint32 seed = 12345;
+	auto start = sdl::timer::peformance_counter();
+	for (int i = 0; i < count; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		handles.push_back(wheel.add(1 + (seed >> 8) % 60000, [&fired](Uint32 interval) { ++fired; return interval; }));
+	}
+	auto add_ms = elapsedMs(start);
+
+	start = sdl::timer::peformance_counter();
+	for (int frame = 1; frame <= 600; ++frame) wheel.advance(frame * 1000 / 60);
+	auto advance_ms = elapsedMs(start);
+
+	start = sdl::timer::peformance_counter();
+	for (auto h : handles) wheel.remove(h);
+	auto remove_ms = elapsedMs(start);
+
+	std::vector<sdl::timer::timer_id> ids;
+	ids.reserve(count);
+	start = sdl::timer::peformance_counter();
+	for (int i = 0; i < count; ++i) {
+		ids.push_back(sdl::timer::add_timer(3600000, [](Uint32, void *) { return 0u; }, nullptr));
+	}
+	auto sdl_add_ms = elapsedMs(start);
+
+	start = sdl::timer::peformance_counter();
+	for (auto id : ids) sdl::timer::remove_timer(id);
+	auto sdl_remove_ms = elapsedMs(start);
+
+	std::cout << "timer_wheel: " << count << " timers, add " << add_ms << " ms"
+		<< ", advance " << advance_ms / 600 << " ms/frame (" << fired << " fired)"
+		<< ", remove " << remove_ms << " ms"
+		<< "; SDL_AddTimer add " << sdl_add_ms << " ms"
+		<< ", remove " << sdl_remove_ms << " ms" << std::endl;
+}
+
+void benchmarkHandleTable()
+{
+	// 100k rects looked up in random order through generational handles,
+	// against the same rects held by shared_ptr and checked via weak_ptr
+	const int count = 100000;
+	const int lookups = 1000000;
+
+	sdl::handle_table<SDL_Rect> table(count);
+	std::vector<sdl::handle_table<SDL_Rect>::handle> handles;
+	std::vector<std::shared_ptr<SDL_Rect>> owners;
+	std::vector<std::weak_ptr<SDL_Rect>> weak;
+	for (int i = 0; i < count; ++i) {
+		handles.push_back(table.emplace(SDL_Rect { i, i, 1, 1 }));
+		owners.push_back(std::make_shared<SDL_Rect>(SDL_Rect { i, i, 1, 1 }));
+		weak.push_back(owners.back());
+	}
+
+	std::vector<int> order(lookups);
+	Uint32 seed = 12345;
+	for (auto &i : order) {
+		seed = seed * 1664525u + 1013904223u;
+		i = static_cast<int>((seed >> 8) % count);
+	}
+
+	long sum = 0;
+	auto start = sdl::timer::peformance_counter();
+	for (auto i : order) {
+		if (auto r = table.find(handles[i])) sum += r->x;
+	}
+	auto table_ms = elapsedMs(start);
+
+	start = sdl::timer::peformance_counter();
+	for (auto i : order) {
+		if (auto r = weak[i].lock()) sum += r->x;
+	}
+	auto shared_ms = elapsedMs(start);
+
+	// the shared_ptr side counts one make_shared block (two counts and a
+	// vtable) per object and a 16-byte pointer per holder
+	auto table_bytes = table.size() * (sizeof(SDL_Rect) + sizeof(Uint32)) + table.capacity() * 2 * sizeof(Uint32) + handles.size() * sizeof(handles[0]);
+	auto shared_bytes = owners.size() * (sizeof(SDL_Rect) + 2 * sizeof(int) + sizeof(void *)) + (owners.size() + weak.size()) * sizeof(owners[0]);
+
+	std::cout << "handle_table: " << lookups << " lookups " << table_ms << " ms"
+		<< ", " << table_bytes / 1024 << " KiB"
+		<< "; shared_ptr " << shared_ms << " ms"
+		<< ", " << shared_bytes / 1024 << " KiB"
+		<< " (checksum " << sum << ")" << std::endl;
+}
+
+void benchmarkArchive()
+{
+	// startup: open and read 1000 loose 1 KiB files, against opening one
+	// archive holding the same files and reading every entry; both run on a
+	// warm file cache, so this measures per-file open overhead
+	const int count = 1000;
+	auto base = sdl::filesystem::pref_path("remyroez", "sdl2-wrapper");
+	if (!base) {
+		printError();
+		return;
+	}
+	std::string directory = base.get();
+
+	std::vector<Uint8> data(1024);
+	std::vector<std::string> names;
+	sdl::archive_writer writer;
+	for (int i = 0; i < count; ++i) {
+		for (std::size_t n = 0; n < data.size(); ++n) data[n] = static_cast<Uint8>(i + n);
+		names.push_back("benchmark_" + std::to_string(i) + ".dat");
+
+		sdl::file loose((directory + names.back()).c_str(), "wb");
+		if (!loose || (loose.write(data.data(), 1, data.size()) != data.size())) {
+			printError();
+			return;
+		}
+		writer.add(names.back(), data.data(), data.size());
+	}
+
+	auto packed = directory + "benchmark.sdla";
+	if (!writer.save(packed.c_str())) {
+		printError();
+		return;
+	}
+
+	std::size_t loose_bytes = 0;
+	auto start = sdl::timer::peformance_counter();
+	for (auto &name : names) {
+		sdl::file loose((directory + name).c_str(), "rb");
+		if (loose) loose_bytes += loose.read(data.data(), 1, data.size());
+	}
+	auto loose_ms = elapsedMs(start);
+
+	std::size_t archive_bytes = 0;
+	start = sdl::timer::peformance_counter();
+	{
+		sdl::archive archive(packed.c_str());
+		for (auto &name : names) {
+			auto entry = archive.open_file(name);
+			if (entry) archive_bytes += entry.read(data.data(), 1, data.size());
+		}
+	}
+	auto archive_ms = elapsedMs(start);
+
+	for (auto &name : names) std::remove((directory + name).c_str());
+	std::remove(packed.c_str());
+
+	std::cout << "archive: " << count << " files, loose " << loose_ms << " ms"
+		<< " (" << loose_bytes << " bytes)"
+		<< ", archive " << archive_ms << " ms"
+		<< " (" << archive_bytes << " bytes)" << std::endl;
+}
+
+void benchmarkImageLoader()
+{
+	// a 1024x1024 ARGB8888 image of flat blocks over a gradient, saved as
+	// BMP, QOI and PNG, then loaded back ten times each
+	const int size = 1024;
+	sdl::surface image(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+	auto base = sdl::filesystem::pref_path("remyroez", "sdl2-wrapper");
+	if (!image || !base) {
+		printError();
+		return;
+	}
+
+	for (int y = 0; y < size; ++y) {
+		auto row = reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(image.pixels()) + y * image.pitch());
+		for (int x = 0; x < size; ++x) row[x] = 0xFF000000 | (static_cast<Uint32>(x / 4) << 16) | (static_cast<Uint32>(y / 4) << 8);
+	}
+	for (int i = 0; i < 64; ++i) {
+		SDL_Rect block { (i % 8) * 128 + 16, (i / 8) * 128 + 16, 96, 96 };
+		image.fill_rect(&block, 0xFF000000 | static_cast<Uint32>(i * 0x03070B));
+	}
+
+	std::string directory = base.get();
+	const char *names[] = { "benchmark.bmp", "benchmark.qoi", "benchmark.png" };
+	bool saved = image.save_bmp((directory + names[0]).c_str());
+	for (auto f : { sdl::image_encoder::format::qoi, sdl::image_encoder::format::png }) {
+		std::vector<Uint8> encoded;
+		auto name = (f == sdl::image_encoder::format::qoi) ? names[1] : names[2];
+		sdl::file out((directory + name).c_str(), "wb");
+		saved = saved && sdl::image_encoder::encode(f, image.pixels(), size, size, image.pitch(), SDL_PIXELFORMAT_ARGB8888, encoded)
+			&& out && (out.write(encoded.data(), 1, encoded.size()) == encoded.size());
+	}
+	if (!saved) {
+		printError();
+		return;
+	}
+
+	sdl::task_system tasks;
+	for (auto name : names) {
+		auto path = directory + name;
+		Sint64 bytes = sdl::file(path.c_str(), "rb").size();
+
+		bool ok = true;
+		auto start = sdl::timer::peformance_counter();
+		for (int i = 0; i < 10; ++i) ok = ok && (sdl::image_loader::load(path.c_str(), SDL_PIXELFORMAT_ARGB8888, &tasks) != nullptr);
+		auto ms = elapsedMs(start) / 10;
+
+		std::cout << "image_loader: " << name << " " << bytes / 1024 << " KiB"
+			<< ", load " << ms << " ms" << (ok ? "" : " failed") << std::endl;
+		std::remove(path.c_str());
+	}
+}
+
+void benchmarkInputSnapshot()
+{
+	// per-frame polling of every axis, button and hat of each open joystick,
+	// through the joystick getters and through one input_snapshot capture
+	const int frames = 10000;
+	std::vector<sdl::joystick> joysticks;
+	for (int i = 0; i < sdl::joystick::count(); ++i) {
+		joysticks.emplace_back(i);
+		if (!joysticks.back()) joysticks.pop_back();
+	}
+
+	long sum = 0;
+	auto start = sdl::timer::peformance_counter();
+	for (int frame = 0; frame < frames; ++frame) {
+		for (auto &j : joysticks) {
+			for (int i = 0, n = j.axes(); i < n; ++i) sum += j.axis(i);
+			for (int i = 0, n = j.buttons(); i < n; ++i) sum += j.button(i);
+			for (int i = 0, n = j.hats(); i < n; ++i) sum += static_cast<int>(j.hat(i));
+		}
+	}
+	auto getters_ms = elapsedMs(start);
+
+	sdl::input_snapshot snapshot;
+	start = sdl::timer::peformance_counter();
+	for (int frame = 0; frame < frames; ++frame) {
+		snapshot.capture();
+		for (std::size_t d = 0; d < snapshot.devices(); ++d) {
+			for (int i = 0, n = snapshot.axes(d); i < n; ++i) sum += snapshot.axis(d, i);
+			for (int i = 0, n = snapshot.buttons(d); i < n; ++i) sum += snapshot.button(d, i);
+			for (int i = 0, n = snapshot.hats(d); i < n; ++i) sum += static_cast<int>(snapshot.hat(d, i));
+		}
+	}
+	auto snapshot_ms = elapsedMs(start);
+
+	std::cout << "input_snapshot: " << joysticks.size() << " devices"
+		<< ", getters " << getters_ms * 1000.0 / frames << " us/frame"
+		<< ", snapshot " << snapshot_ms * 1000.0 / frames << " us/frame"
+		<< " (checksum " << sum << ")" << std::endl;
+}
+
+Uint32 frameChecksum(const void *pixels, int pitch, int height)
+{
+	// stands in for encoding: touches every byte of the frame
+	Uint32 a = 1, b = 0;
+	for (int y = 0; y < height; ++y) {
+		auto row = static_cast<const Uint8 *>(pixels) + y * pitch;
+		for (int x = 0; x < pitch; ++x) {
+			a = (a + row[x]) % 65521;
+			b = (b + a) % 65521;
+		}
+	}
+	return (b << 16) | a;
+}
+
+void drawFrame(sdl::renderer &renderer, int frame)
+{
+	renderer.clear(0x20, 0x20, 0x20);
+	renderer.draw_color(static_cast<Uint8>(frame * 7), 0x80, 0xC0, 0xFF);
+	for (int i = 0; i < 64; ++i) {
+		SDL_Rect r { (i * 97 + frame * 5) % 1800, (i * 61) % 1000, 120, 80 };
+		renderer.fill_rect(&r);
+	}
+}
+
+void benchmarkOffscreenTarget()
+{
+	// 1080p software rendering with a consumer that reads every frame: a
+	// single surface renderer with read_pixels, against a double-buffered
+	// offscreen_target whose frames are consumed on another thread; neither
+	// needs a window, so this runs the same under the dummy video driver
+	const int width = 1920, height = 1080, frames = 60;
+
+	sdl::surface canvas(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::renderer renderer(canvas.get());
+	sdl::offscreen_target target(width, height);
+	if (!canvas || !renderer || !target.valid()) {
+		printError();
+		return;
+	}
+
+	Uint32 read_sum = 0, offscreen_sum = 0;
+	std::vector<Uint8> copy(static_cast<std::size_t>(width) * height * 4);
+	auto start = sdl::timer::peformance_counter();
+	for (int frame = 0; frame < frames; ++frame) {
+		drawFrame(renderer, frame);
+		renderer.present();
+		renderer.read_pixels(nullptr, SDL_PIXELFORMAT_ARGB8888, copy.data(), width * 4);
+		read_sum += frameChecksum(copy.data(), width * 4, height);
+	}
+	auto read_ms = elapsedMs(start);
+
+	std::mutex mutex;
+	std::condition_variable signal;
+	std::vector<sdl::offscreen_target::frame> queue;
+	bool done = false;
+	std::thread consumer([&] {
+		while (true) {
+			sdl::offscreen_target::frame f;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				signal.wait(lock, [&] { return done || !queue.empty(); });
+				if (queue.empty()) return;
+				f = std::move(queue.front());
+				queue.erase(queue.begin());
+			}
+			offscreen_sum += frameChecksum(f.pixels(), f.pitch(), f.h());
+		}
+	});
+
+	start = sdl::timer::peformance_counter();
+	for (int frame = 0; frame < frames; ++frame) {
+		drawFrame(*target.begin(), frame);
+		auto f = target.end();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			queue.push_back(std::move(f));
+		}
+		signal.notify_one();
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		done = true;
+	}
+	signal.notify_one();
+	consumer.join();
+	auto offscreen_ms = elapsedMs(start);
+
+	std::cout << "offscreen_target: 1080p read_pixels " << frames * 1000.0 / read_ms << " fps"
+		<< ", double buffered " << frames * 1000.0 / offscreen_ms << " fps"
+		<< ", " << target.stats().stalls << " stalls"
+		<< ((read_sum == offscreen_sum) ? " ok" : " failed") << std::endl;
+}
+
+void benchmarkFrameCapture()
+{
+	// render-thread stall per captured 1280x720 frame: read_pixels into a
+	// surface and save_bmp on the render thread, against frame_capture
+	// handing the pixels to two PNG encoder threads; captures are paced at
+	// 60 Hz so the encoders get the frame time a game would leave them
+	const int width = 1280, height = 720, frames = 30;
+	sdl::surface canvas(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::surface copy(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::renderer renderer(canvas.get());
+	auto base = sdl::filesystem::pref_path("remyroez", "sdl2-wrapper");
+	if (!canvas || !copy || !renderer || !base) {
+		printError();
+		return;
+	}
+	std::string directory = base.get();
+
+	Uint64 baseline = 0;
+	for (int frame = 0; frame < frames; ++frame) {
+		drawFrame(renderer, frame);
+		auto start = sdl::timer::peformance_counter();
+		renderer.read_pixels(nullptr, SDL_PIXELFORMAT_ARGB8888, copy.pixels(), copy.pitch());
+		copy.save_bmp((directory + "capture_" + std::to_string(frame) + ".bmp").c_str());
+		baseline += sdl::timer::peformance_counter() - start;
+	}
+
+	sdl::frame_capture::statistics stats;
+	{
+		sdl::frame_capture capture(sdl::frame_capture::encoding::png, 2, 4);
+		for (int frame = 0; frame < frames; ++frame) {
+			drawFrame(renderer, frame);
+			capture.capture(renderer, directory + "capture_" + std::to_string(frame) + ".png");
+			sdl::timer::delay(1000/60);
+		}
+		capture.flush();
+		stats = capture.stats();
+	}
+
+	for (int frame = 0; frame < frames; ++frame) {
+		std::remove((directory + "capture_" + std::to_string(frame) + ".bmp").c_str());
+		std::remove((directory + "capture_" + std::to_string(frame) + ".png").c_str());
+	}
+
+	auto ms = 1000.0 / static_cast<double>(sdl::timer::peformance_frequency());
+	std::cout << "frame_capture: stall per frame, read_pixels + save_bmp " << static_cast<double>(baseline) * ms / frames << " ms"
+		<< ", frame_capture " << static_cast<double>(stats.stall) * ms / frames << " ms"
+		<< " (" << stats.written << " written, " << stats.dropped << " dropped)" << std::endl;
+}
+
+void benchmarkEventRecorder()
+{
+	// per-event cost of recording: push and flush the same stream of mouse
+	// motion and text input events with and without an event_recorder
+	// watching the queue
+	const int count = 100000, batch = 1000;
+	auto run = [&](sdl::event_recorder *recorder) {
+		if (recorder != nullptr) recorder->start();
+		auto start = sdl::timer::peformance_counter();
+		for (int i = 0; i < count; ++i) {
+			SDL_Event event;
+			SDL_zero(event);
+			if ((i % 4) == 3) {
+				event.type = SDL_TEXTINPUT;
+				SDL_strlcpy(event.text.text, ((i % 8) == 3) ? "w" : "a", sizeof(event.text.text));
+			} else {
+				event.type = SDL_MOUSEMOTION;
+				event.motion.x = i % 1280;
+				event.motion.y = i % 720;
+			}
+			sdl::event_handler::push(&event);
+			if ((i % batch) == (batch - 1)) sdl::event_handler::flush_events(SDL_FIRSTEVENT, SDL_LASTEVENT);
+		}
+		sdl::event_handler::flush_events(SDL_FIRSTEVENT, SDL_LASTEVENT);
+		auto ms = elapsedMs(start);
+		if (recorder != nullptr) recorder->stop();
+		return ms;
+	};
+
+	auto plain = run(nullptr);
+	sdl::event_recorder recorder;
+	auto recorded = run(&recorder);
+	auto stats = recorder.stats();
+
+	std::cout << "event_recorder: " << count << " events, push " << plain * 1000000.0 / count << " ns"
+		<< ", push + record " << recorded * 1000000.0 / count << " ns"
+		<< " (" << stats.records << " records, " << stats.bytes << " bytes)" << std::endl;
+}
+
+void benchmarkTaskSystem()
+{
+	// scaling over worker counts: a compute-bound parallel_for over 4M
+	// values and nested fork/join (fibonacci), against the loop run serially
+	const int count = 1 << 22;
+	std::vector<Uint32> values(count);
+	auto kernel = [&values](int begin, int end) {
+		for (int i = begin; i < end; ++i) {
+			auto x = static_cast<Uint32>(i);
+			for (int round = 0; round < 16; ++round) x = (x ^ (x >> 15)) * 0x2c1b3c6dU;
+			values[i] = x;
+		}
+	};
+
+	auto start = sdl::timer::peformance_counter();
+	kernel(0, count);
+	auto serial = elapsedMs(start);
+	auto expected = values;
+	std::cout << "task_system: serial " << serial << " ms" << std::endl;
+
+	std::vector<unsigned int> counts;
+	auto most = static_cast<unsigned int>(std::max(1, sdl::cpu::cores() - 1));
+	for (unsigned int threads = 1; threads < most; threads *= 2) counts.push_back(threads);
+	counts.push_back(most);
+
+	for (auto threads : counts) {
+		sdl::task_system tasks(threads);
+		std::fill(values.begin(), values.end(), 0);
+
+		start = sdl::timer::peformance_counter();
+		tasks.parallel_for(0, count, 4096, kernel);
+		auto loop = elapsedMs(start);
+
+		start = sdl::timer::peformance_counter();
+		auto fib = fibonacci(tasks, 36);
+		auto nested = elapsedMs(start);
+
+		bool ok = (values == expected) && (fib == 14930352);
+		std::cout << "task_system: " << threads << " workers, parallel_for " << loop << " ms"
+			<< " (x" << serial / loop << "), fibonacci " << nested << " ms"
+			<< (ok ? " ok" : " failed") << std::endl;
+	}
+}
+
+void benchmarkProfiler()
+{
+	// cost per zone: the same small loop body with and without a
+	// profile_zone around it, 4000 zones per frame so the ring never drops,
+	// and the frame() drain and aggregation on top
+	const int frames = 100, zones = 4000;
+	auto body = [](Uint32 x) {
+		for (int round = 0; round < 8; ++round) x = (x ^ (x >> 15)) * 0x2c1b3c6dU;
+		return x;
+	};
+	auto &profiler = sdl::timer::profiler::instance();
+	profiler.frame();
+
+	Uint32 plainSum = 0;
+	auto start = sdl::timer::peformance_counter();
+	for (int frame = 0; frame < frames; ++frame) {
+		for (int i = 0; i < zones; ++i) plainSum += body(static_cast<Uint32>(i));
+	}
+	auto plain = elapsedMs(start);
+
+	Uint32 zonedSum = 0;
+	double drain = 0.0;
+	start = sdl::timer::peformance_counter();
+	for (int frame = 0; frame < frames; ++frame) {
+		for (int i = 0; i < zones; ++i) {
+			sdl::timer::profile_zone zone("benchmark");
+			zonedSum += body(static_cast<Uint32>(i));
+		}
+		auto drainStart = sdl::timer::peformance_counter();
+		profiler.frame();
+		drain += elapsedMs(drainStart);
+	}
+	auto zoned = elapsedMs(start) - drain;
+
+	const double count = static_cast<double>(frames) * zones;
+	std::cout << "profiler: " << (zoned - plain) * 1000000.0 / count << " ns per zone"
+		<< ", frame() " << drain / frames << " ms per " << zones << " zones"
+		<< ", " << profiler.dropped() << " dropped"
+		<< ((plainSum == zonedSum) ? " ok" : " failed") << std::endl;
+}
+
+void benchmarkAsyncLog()
+{
+	// caller latency (mean and p99 per call) and end-to-end time of 50000
+	// records: SDL_Log through a synchronous output function writing to a
+	// file, against async_log in text mode behind SDL_Log and in binary
+	// mode through write(); the async rings hold the whole burst so no
+	// record is dropped
+	const int count = 50000;
+	auto base = sdl::filesystem::pref_path("remyroez", "sdl2-wrapper");
+	if (!base) {
+		printError();
+		return;
+	}
+	std::string directory = base.get();
+
+	std::vector<Uint64> calls(count);
+	auto report = [&calls](const char *name, double total, const char *extra) {
+		std::sort(calls.begin(), calls.end());
+		Uint64 sum = 0;
+		for (auto c : calls) sum += c;
+		auto us = 1000000.0 / static_cast<double>(sdl::timer::peformance_frequency());
+		std::cout << "async_log: " << name << " " << static_cast<double>(sum) * us / count << " us per call"
+			<< ", p99 " << static_cast<double>(calls[count * 99 / 100]) * us << " us"
+			<< ", " << total << " ms total" << extra << std::endl;
+	};
+
+	sdl::log::callback previous;
+	void *previousUserdata;
+	sdl::log::output(&previous, &previousUserdata);
+
+	{
+		auto path = directory + "log_sync.txt";
+		auto file = SDL_RWFromFile(path.c_str(), "wb");
+		if (file == nullptr) {
+			printError();
+			return;
+		}
+		sdl::log::output([](void *userdata, int, SDL_LogPriority, const char *message) {
+			auto file = static_cast<SDL_RWops *>(userdata);
+			SDL_RWwrite(file, message, 1, SDL_strlen(message));
+			SDL_RWwrite(file, "\n", 1, 1);
+		}, file);
+
+		auto start = sdl::timer::peformance_counter();
+		for (int i = 0; i < count; ++i) {
+			auto call = sdl::timer::peformance_counter();
+			SDL_Log("frame %d position %d,%d", i, i % 640, i % 480);
+			calls[i] = sdl::timer::peformance_counter() - call;
+		}
+		auto total = elapsedMs(start);
+		sdl::log::output(previous, previousUserdata);
+		SDL_RWclose(file);
+		std::remove(path.c_str());
+		report("synchronous SDL_Log", total, "");
+	}
+
+	for (auto mode : { sdl::async_log::encoding::text, sdl::async_log::encoding::binary }) {
+		bool binary = (mode == sdl::async_log::encoding::binary);
+		auto path = directory + (binary ? "log_async.bin" : "log_async.txt");
+		sdl::async_log::statistics stats;
+		double total;
+		{
+			sdl::async_log log(path.c_str(), mode, 1 << 23);
+			if (!log.valid()) {
+				printError();
+				return;
+			}
+			log.install();
+
+			auto start = sdl::timer::peformance_counter();
+			for (int i = 0; i < count; ++i) {
+				auto call = sdl::timer::peformance_counter();
+				if (binary) {
+					log.write<sdl::log::category::application, sdl::log::priority::information>(SDL2_WRAPPER_LOG_FORMAT("frame {} position {},{}"), i, i % 640, i % 480);
+				} else {
+					SDL_Log("frame %d position %d,%d", i, i % 640, i % 480);
+				}
+				calls[i] = sdl::timer::peformance_counter() - call;
+			}
+			log.flush();
+			total = elapsedMs(start);
+			log.uninstall();
+			stats = log.stats();
+		}
+		std::remove(path.c_str());
+
+		auto extra = " (" + std::to_string(stats.records) + " records, " + std::to_string(stats.dropped) + " dropped)";
+		report(binary ? "binary write()" : "text SDL_Log", total, extra.c_str());
+	}
+}
+
+void benchmarkLogFormat()
+{
+	// per-call cost of log.hpp into an output function that only counts:
+	// printf-style and typed formatting, a level filtered at run time, and
+	// a category compiled out through SDL2_WRAPPER_LOG_DISABLED_CATEGORIES
+	const int count = 200000;
+	using category = sdl::log::category;
+
+	sdl::log::callback previous;
+	void *previousUserdata;
+	sdl::log::output(&previous, &previousUserdata);
+
+	int written = 0;
+	sdl::log::output([](void *userdata, int, SDL_LogPriority, const char *) { ++*static_cast<int *>(userdata); }, &written);
+
+	auto time = [count](const char *name, auto fn) {
+		auto start = sdl::timer::peformance_counter();
+		for (int i = 0; i < count; ++i) fn(i);
+		std::cout << "log: " << name << " " << elapsedMs(start) * 1000000.0 / count << " ns per call" << std::endl;
+	};
+	time("printf-style", [](int i) {
+		sdl::log::information(category::application, "frame %d position %d,%d scale %f", i, i % 640, i % 480, 1.5);
+	});
+	time("typed", [](int i) {
+		sdl::log::info<category::application>(SDL2_WRAPPER_LOG_FORMAT("frame {} position {},{} scale {}"), i, i % 640, i % 480, 1.5);
+	});
+	time("filtered at run time", [](int i) {
+		sdl::log::verbose<category::application>(SDL2_WRAPPER_LOG_FORMAT("frame {} position {},{} scale {}"), i, i % 640, i % 480, 1.5);
+	});
+	time("compiled out", [](int i) {
+		sdl::log::info<category::reserved10>(SDL2_WRAPPER_LOG_FORMAT("frame {} position {},{} scale {}"), i, i % 640, i % 480, 1.5);
+	});
+
+	sdl::log::output(previous, previousUserdata);
+	std::cout << "log: " << written << " messages written" << ((written == 2 * count) ? " ok" : " failed") << std::endl;
+}
+
+void benchmarkSurfaceView()
+{
+	// per-pixel read-modify-write over a 1024x1024 ARGB8888 surface:
+	// SDL_GetRGBA/SDL_MapRGBA through the runtime format, against a
+	// surface_view using the constexpr traits; both must agree
+	const int width = 1024, height = 1024, passes = 10;
+	sdl::surface generic(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::surface typed(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (!generic || !typed) {
+		printError();
+		return;
+	}
+	for (int y = 0; y < height; ++y) {
+		auto row = static_cast<Uint32 *>(generic.pixels()) + y * (generic.pitch() / 4);
+		for (int x = 0; x < width; ++x) row[x] = static_cast<Uint32>(x * 2654435761U + y * 40503U);
+	}
+	SDL_memcpy(typed.pixels(), generic.pixels(), static_cast<std::size_t>(generic.pitch()) * height);
+
+	auto start = sdl::timer::peformance_counter();
+	auto format = generic.get()->format;
+	for (int pass = 0; pass < passes; ++pass) {
+		for (int y = 0; y < height; ++y) {
+			auto row = static_cast<Uint32 *>(generic.pixels()) + y * (generic.pitch() / 4);
+			for (int x = 0; x < width; ++x) {
+				Uint8 r, g, b, a;
+				SDL_GetRGBA(row[x], format, &r, &g, &b, &a);
+				row[x] = SDL_MapRGBA(format, g, b, r, a);
+			}
+		}
+	}
+	auto sdlMs = elapsedMs(start);
+
+	start = sdl::timer::peformance_counter();
+	{
+		sdl::surface_view<SDL_PIXELFORMAT_ARGB8888> view(typed);
+		for (int pass = 0; pass < passes; ++pass) {
+			for (int y = 0; y < height; ++y) {
+				for (auto pixel : view.row(y)) {
+					sdl::color c = pixel;
+					pixel = sdl::color(c.g, c.b, c.r, c.a);
+				}
+			}
+		}
+	}
+	auto viewMs = elapsedMs(start);
+
+	bool ok = (SDL_memcmp(generic.pixels(), typed.pixels(), static_cast<std::size_t>(generic.pitch()) * height) == 0);
+	std::cout << "surface_view: " << passes << " passes over " << width << "x" << height
+		<< ", SDL_GetRGBA/SDL_MapRGBA " << sdlMs / passes << " ms, surface_view " << viewMs / passes << " ms"
+		<< (ok ? " ok" : " failed") << std::endl;
+}
+
+void benchmarkPaletteQuantizer()
+{
+	// time and RMS error of quantizing a 512x512 photo-like gradient to
+	// 256, 64 and 16 colors in each dither mode, serially and on the task
+	// system, against SDL converting to the fixed 256-color RGB332 format
+	const int width = 512, height = 512;
+	sdl::surface source(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (!source) {
+		printError();
+		return;
+	}
+	for (int y = 0; y < height; ++y) {
+		auto row = static_cast<Uint32 *>(source.pixels()) + y * (source.pitch() / 4);
+		for (int x = 0; x < width; ++x) {
+			auto r = static_cast<Uint32>(x * 255 / width);
+			auto g = static_cast<Uint32>(y * 255 / height);
+			auto b = static_cast<Uint32>(((x * y) >> 7) & 0xff);
+			row[x] = 0xff000000U | (r << 16) | (g << 8) | b;
+		}
+	}
+
+	// RMS error per pixel and over 4x4 block averages, which is closer to
+	// what dithering is judged by; both the RGB332 and the INDEX8 results
+	// have one byte per pixel
+	struct error {
+		double pixel;
+		double block;
+	};
+	auto measure = [&source](SDL_Surface *quantized) {
+		const int block = 4;
+		double pixel = 0.0, averaged = 0.0;
+		for (int by = 0; by < height; by += block) {
+			for (int bx = 0; bx < width; bx += block) {
+				int sum[3] = { 0, 0, 0 };
+				for (int y = by; y < by + block; ++y) {
+					auto in = static_cast<const Uint32 *>(source.pixels()) + y * (source.pitch() / 4);
+					auto out = static_cast<const Uint8 *>(quantized->pixels) + y * quantized->pitch;
+					for (int x = bx; x < bx + block; ++x) {
+						Uint8 rgb[3];
+						SDL_GetRGB(out[x], quantized->format, &rgb[0], &rgb[1], &rgb[2]);
+						for (int c = 0; c < 3; ++c) {
+							auto d = static_cast<int>((in[x] >> (16 - c * 8)) & 0xff) - rgb[c];
+							pixel += d * d;
+							sum[c] += d;
+						}
+					}
+				}
+				for (int c = 0; c < 3; ++c) {
+					auto d = sum[c] / static_cast<double>(block * block);
+					averaged += d * d;
+				}
+			}
+		}
+		return error { SDL_sqrt(pixel / (width * height * 3.0)), SDL_sqrt(averaged / (width * height * 3.0 / (block * block))) };
+	};
+
+	auto start = sdl::timer::peformance_counter();
+	auto fixed = source.convert_format(SDL_PIXELFORMAT_RGB332, 0);
+	auto fixedMs = elapsedMs(start);
+	if (fixed == nullptr) {
+		printError();
+		return;
+	}
+	auto fixedError = measure(fixed);
+	std::cout << "palette_quantizer: SDL RGB332 " << fixedMs << " ms"
+		<< ", rmse " << fixedError.pixel << " (4x4 " << fixedError.block << ")" << std::endl;
+	SDL_FreeSurface(fixed);
+
+	const char *modes[] = { "none", "ordered", "floyd_steinberg" };
+	sdl::task_system tasks;
+	for (auto colors : { 256, 64, 16 }) {
+		for (int mode = 0; mode < 3; ++mode) {
+			double ms[2];
+			error quality = { 0.0, 0.0 };
+			bool ok = true;
+			for (int parallel = 0; parallel < 2; ++parallel) {
+				sdl::surface target;
+				start = sdl::timer::peformance_counter();
+				ok = sdl::palette_quantizer::quantize(source, colors, target, static_cast<sdl::palette_quantizer::dither>(mode), parallel ? &tasks : nullptr) && ok;
+				ms[parallel] = elapsedMs(start);
+				if (ok) quality = measure(target.get());
+			}
+			std::cout << "palette_quantizer: " << colors << " colors, " << modes[mode]
+				<< ", serial " << ms[0] << " ms, " << tasks.size() << " workers " << ms[1] << " ms"
+				<< ", rmse " << quality.pixel << " (4x4 " << quality.block << ")" << (ok ? " ok" : " failed") << std::endl;
+		}
+	}
+}
+
+void benchmarkSpriteStore()
+{
+	// 32 round 64x64 sprites with soft edges, kept as plain blended
+	// surfaces and in a sprite_store: memory, then 20000 blits onto a
+	// 1280x720 ARGB8888 target with SDL_BlitSurface against the run-length
+	// blit
+	const int size = 64, count = 32, blits = 20000;
+	const int width = 1280, height = 720;
+	std::vector<sdl::surface> sprites;
+	sdl::sprite_store store;
+	for (int i = 0; i < count; ++i) {
+		sprites.emplace_back(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+		auto &sprite = sprites.back();
+		if (!sprite) {
+			printError();
+			return;
+		}
+		for (int y = 0; y < size; ++y) {
+			auto row = static_cast<Uint32 *>(sprite.pixels()) + y * (sprite.pitch() / 4);
+			for (int x = 0; x < size; ++x) {
+				auto dx = x - size / 2, dy = y - size / 2;
+				auto distance = dx * dx + dy * dy, radius = (size / 2 - i % 8) * (size / 2 - i % 8);
+				Uint32 alpha = (distance > radius) ? 0 : (distance > radius - 4 * size) ? 0x80 : 0xff;
+				row[x] = (alpha << 24) | (static_cast<Uint32>(i * 8) << 16) | (static_cast<Uint32>(x * 4) << 8) | static_cast<Uint32>(y * 4);
+			}
+		}
+		sprite.blend_mode(SDL_BLENDMODE_BLEND);
+		if (store.add(sprite) == sdl::sprite_store::invalid_id) {
+			printError();
+			return;
+		}
+	}
+
+	sdl::surface target(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (!target) {
+		printError();
+		return;
+	}
+
+	auto place = [](int i, int extent, int limit) { return (i * 7919) % (limit + extent) - extent / 2; };
+	auto time = [&](std::function<void (int, int, int)> blit) {
+		target.fill_rect(nullptr, 0xff204060);
+		auto start = sdl::timer::peformance_counter();
+		for (int i = 0; i < blits; ++i) blit(i % count, place(i, size, width), place(i / 3, size, height));
+		return elapsedMs(start);
+	};
+	auto sdlMs = time([&](int sprite, int x, int y) {
+		SDL_Rect position { x, y, 0, 0 };
+		sprites[sprite].blit(nullptr, target.get(), &position);
+	});
+	auto storeMs = time([&](int sprite, int x, int y) { store.blit(sprite, target, x, y); });
+
+	std::cout << "sprite_store: " << count << " sprites, " << store.memory() << " bytes against " << store.raw_memory() << " raw"
+		<< ", " << blits << " blits, SDL_BlitSurface " << sdlMs << " ms, sprite_store " << storeMs << " ms" << std::endl;
+}
+
+void benchmarkTilemapRenderer()
+{
+	// draw calls and frame time for a 256x256 map of 16x16 tiles scrolled
+	// diagonally across a 1280x720 software renderer, one tile changing
+	// per frame: per-tile copies against chunks cached in target textures;
+	// both must leave the same last frame
+	const int width = 1280, height = 720, frames = 120, tile = 16, size = 256;
+	sdl::surface canvas(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::surface sheet(0, 16 * tile, 16 * tile, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::renderer renderer(canvas.get());
+	if (!canvas || !sheet || !renderer) {
+		printError();
+		return;
+	}
+	for (int y = 0; y < sheet.h(); ++y) {
+		auto row = static_cast<Uint32 *>(sheet.pixels()) + y * (sheet.pitch() / 4);
+		for (int x = 0; x < sheet.w(); ++x) {
+			auto index = static_cast<Uint32>((y / tile) * 16 + x / tile);
+			row[x] = 0xff000000U | (index << 16) | (static_cast<Uint32>(x % tile) << 12) | static_cast<Uint32>((y % tile) << 4);
+		}
+	}
+	sdl::texture tileset(renderer.get(), sheet.get());
+	if (!tileset) {
+		printError();
+		return;
+	}
+
+	Uint32 sums[2];
+	for (int cached = 0; cached < 2; ++cached) {
+		sdl::tilemap_renderer map(renderer, tileset.get(), tile, tile, size, size);
+		map.cached(cached != 0);
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) map.set(x, y, static_cast<sdl::tilemap_renderer::tile_type>((x * 7 + y * 13) % 256));
+		}
+
+		std::size_t copies = 0, redrawn = 0;
+		auto start = sdl::timer::peformance_counter();
+		for (int frame = 0; frame < frames; ++frame) {
+			renderer.clear(0x20, 0x20, 0x20);
+			map.set(frame % size, (frame * 3) % size, static_cast<sdl::tilemap_renderer::tile_type>(frame % 256));
+			map.draw(frame * 8, frame * 5);
+			copies += map.stats().copies;
+			redrawn += map.stats().redrawn;
+			renderer.present();
+		}
+		auto ms = elapsedMs(start);
+		sums[cached] = frameChecksum(canvas.pixels(), canvas.pitch(), height);
+
+		std::cout << "tilemap_renderer: " << (map.cached() ? "cached" : "direct")
+			<< ", " << copies / frames << " copies per frame, " << redrawn << " chunks redrawn"
+			<< ", " << ms / frames << " ms per frame" << std::endl;
+	}
+	std::cout << "tilemap_renderer: " << ((sums[0] == sums[1]) ? "ok" : "failed") << std::endl;
+}
+
+void benchmarkSpriteBatch()
+{
+	// 5000 rotated, scaled and tinted 32x32 sprites per frame from two
+	// atlas textures onto a 1280x720 software renderer: one
+	// SDL_RenderCopyEx per sprite against one SDL_RenderGeometry per run
+	// of sprites sharing a texture
+	const int width = 1280, height = 720, frames = 30, count = 5000, size = 32;
+	sdl::surface canvas(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::surface sheet(0, 8 * size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+	sdl::renderer renderer(canvas.get());
+	if (!canvas || !sheet || !renderer) {
+		printError();
+		return;
+	}
+	for (int y = 0; y < sheet.h(); ++y) {
+		auto row = static_cast<Uint32 *>(sheet.pixels()) + y * (sheet.pitch() / 4);
+		for (int x = 0; x < sheet.w(); ++x) row[x] = 0xff000000U | (static_cast<Uint32>(x) << 14) | static_cast<Uint32>(y << 3);
+	}
+	sdl::texture first(renderer.get(), sheet.get()), second(renderer.get(), sheet.get());
+	if (!first || !second) {
+		printError();
+		return;
+	}
+	SDL_Texture *atlases[] = { first.get(), second.get() };
+
+	for (int geometry = 0; geometry < 2; ++geometry) {
+		sdl::sprite_batch batch(renderer, count);
+		batch.geometry(geometry != 0);
+		if (batch.geometry() != (geometry != 0)) {
+			std::cout << "sprite_batch: geometry is not supported by this renderer" << std::endl;
+			break;
+		}
+
+		std::size_t calls = 0, batches = 0;
+		auto start = sdl::timer::peformance_counter();
+		for (int frame = 0; frame < frames; ++frame) {
+			renderer.clear(0x20, 0x20, 0x20);
+			for (int i = 0; i < count; ++i) {
+				sdl::rect source((i % 8) * size, 0, size, size);
+				auto x = static_cast<float>((i * 97 + frame * 3) % width);
+				auto y = static_cast<float>((i * 61 + frame * 2) % height);
+				auto tint = sdl::color(0xFF, static_cast<Uint8>(i), 0xFF, 0xC0);
+				batch.draw(atlases[(i / 64) % 2], source, x, y, static_cast<float>((i + frame) % 360), 0.5f + (i % 4) * 0.25f, tint);
+			}
+			batch.flush();
+			calls += batch.stats().calls;
+			batches += batch.stats().batches;
+			renderer.present();
+		}
+		auto ms = elapsedMs(start);
+
+		std::cout << "sprite_batch: " << (geometry ? "geometry" : "copy") << ", " << count << " sprites"
+			<< ", " << batches / frames << " batches, " << calls / frames << " calls"
+			<< ", " << ms / frames << " ms per frame" << std::endl;
+	}
+}
+
+void benchmarkStaticResource()
+{
+	// wrapper cost of creating and destroying 1M handles around
+	// SDL_AllocRW/SDL_FreeRW: raw calls, detail::resource with a deleter
+	// pointer and virtual destructor, and static_resource with the
+	// releaser in its type
+	using dynamic = sdl::detail::resource<SDL_RWops, decltype(&SDL_FreeRW)>;
+	using fixed = sdl::detail::static_resource<SDL_RWops, SDL_FreeRW>;
+	const int count = 1000000;
+
+	auto start = sdl::timer::peformance_counter();
+	for (int i = 0; i < count; ++i) SDL_FreeRW(SDL_AllocRW());
+	auto rawMs = elapsedMs(start);
+
+	start = sdl::timer::peformance_counter();
+	for (int i = 0; i < count; ++i) dynamic handle(SDL_AllocRW(), SDL_FreeRW);
+	auto dynamicMs = elapsedMs(start);
+
+	start = sdl::timer::peformance_counter();
+	for (int i = 0; i < count; ++i) fixed handle(SDL_AllocRW());
+	auto fixedMs = elapsedMs(start);
+
+	std::cout << "static_resource: " << count << " handles, raw " << rawMs << " ms"
+		<< ", detail::resource " << dynamicMs << " ms (" << sizeof(dynamic) << " bytes)"
+		<< ", static_resource " << fixedMs << " ms (" << sizeof(fixed) << " bytes)" << std::endl;
+}
+
 } // namespace
 
 int main(int argc, char* argv[])
@@ -88,6 +1309,34 @@ int main(int argc, char* argv[])
 		return 1;
 
 	} else {
+		if (!checkResourceCache()) result = 1;
+		if (!checkTaskSystem()) result = 1;
+		if (!checkFrameClock()) result = 1;
+		if (!checkTextureManager()) result = 1;
+		if (!checkEventRecording()) result = 1;
+
+		// benchmarks are slow, so they only run when asked for
+		if ((argc > 1) && (SDL_strcmp(argv[1], "--benchmark") == 0)) {
+			benchmarkTimerWheel();
+			benchmarkHandleTable();
+			benchmarkArchive();
+			benchmarkImageLoader();
+			benchmarkInputSnapshot();
+			benchmarkOffscreenTarget();
+			benchmarkFrameCapture();
+			benchmarkEventRecorder();
+			benchmarkTaskSystem();
+			benchmarkProfiler();
+			benchmarkAsyncLog();
+			benchmarkLogFormat();
+			benchmarkSurfaceView();
+			benchmarkPaletteQuantizer();
+			benchmarkSpriteStore();
+			benchmarkTilemapRenderer();
+			benchmarkSpriteBatch();
+			benchmarkStaticResource();
+		}
+
 		auto audio_driver_list = sdl::audio_driver::enumerate();
 		std::cout << "audio drivers: " << std::endl;
 		for (auto &it : audio_driver_list) {